@@ -0,0 +1,388 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_ADAPTORS_HPP
+#define EX4_ADAPTORS_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace genericContainer {
+
+    // Lazy range adaptors for the order views (or any range with begin()/end()):
+    //   c.ascendingOrder() | filter(even) | take(100) | transform(twice)
+    // Nothing is copied – each adaptor wraps the iterators of the one before, and the
+    // whole pipeline runs as a single loop when it is iterated. A range piped as an
+    // lvalue is referenced (it must outlive the pipeline); a temporary is moved in.
+    namespace adaptors {
+
+        // Refers to a range piped as an lvalue
+        template<typename Range>
+        class RangeRef {
+        private:
+            const Range* range;
+
+        public:
+            explicit RangeRef(const Range& range) : range(&range) {}
+
+            auto begin() const {
+                return range->begin();
+            }
+
+            auto end() const {
+                return range->end();
+            }
+        };
+
+        // How an adaptor holds its input: lvalues by reference, temporaries by value
+        template<typename Range>
+        using Stored = std::conditional_t<std::is_lvalue_reference<Range>::value,
+                                          RangeRef<std::decay_t<Range>>, std::decay_t<Range>>;
+
+        template<typename Range>
+        using IteratorOf = decltype(std::declval<const Range&>().begin());
+
+        // Forward if the base iterator is, else input (e.g. over a transform)
+        template<typename BaseIterator>
+        using ForwardIfBase = std::conditional_t<
+                std::is_base_of<std::forward_iterator_tag,
+                                typename std::iterator_traits<BaseIterator>::iterator_category>::value,
+                std::forward_iterator_tag, std::input_iterator_tag>;
+
+        // Elements of base for which pred is true, skipped to as the iterator advances
+        template<typename Base, typename Pred>
+        class FilterView {
+        private:
+            Base base;
+            Pred pred;
+
+        public:
+            class Iterator {
+            public:
+                using BaseIterator = IteratorOf<Base>;
+                using iterator_category = ForwardIfBase<BaseIterator>;
+                using value_type = typename std::iterator_traits<BaseIterator>::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = typename std::iterator_traits<BaseIterator>::pointer;
+                using reference = typename std::iterator_traits<BaseIterator>::reference;
+
+            private:
+                BaseIterator current;
+                BaseIterator last;
+                const Pred* pred;
+
+                // Moves to the first element from current on that pred accepts
+                void skip() {
+                    while (current != last && !(*pred)(*current)) {
+                        ++current;
+                    }
+                }
+
+            public:
+                Iterator() : pred(nullptr) {}
+
+                Iterator(BaseIterator current, BaseIterator last, const Pred* pred)
+                        : current(current), last(last), pred(pred) {
+                    skip();
+                }
+
+                reference operator*() const {
+                    return *current;
+                }
+
+                Iterator& operator++() {
+                    ++current;
+                    skip();
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    Iterator temp = *this;
+                    ++(*this);
+                    return temp;
+                }
+
+                bool operator==(const Iterator& other) const {
+                    return current == other.current;
+                }
+
+                bool operator!=(const Iterator& other) const {
+                    return !(*this == other);
+                }
+            };
+
+            FilterView(Base base, Pred pred)
+                    : base(std::move(base)), pred(std::move(pred)) {}
+
+            // O(k) – skips the k rejected elements before the first match
+            Iterator begin() const {
+                return Iterator(base.begin(), base.end(), &pred);
+            }
+
+            Iterator end() const {
+                return Iterator(base.end(), base.end(), &pred);
+            }
+        };
+
+        // f(element) for each element of base, computed on dereference
+        template<typename Base, typename Function>
+        class TransformView {
+        private:
+            Base base;
+            Function function;
+
+        public:
+            class Iterator {
+            public:
+                using BaseIterator = IteratorOf<Base>;
+                using iterator_category = std::input_iterator_tag;  // Dereferencing yields a value
+                using reference = std::invoke_result_t<const Function&,
+                                                       typename std::iterator_traits<BaseIterator>::reference>;
+                using value_type = std::decay_t<reference>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+
+            private:
+                BaseIterator current;
+                const Function* function;
+
+            public:
+                Iterator() : function(nullptr) {}
+
+                Iterator(BaseIterator current, const Function* function)
+                        : current(current), function(function) {}
+
+                reference operator*() const {
+                    return (*function)(*current);
+                }
+
+                Iterator& operator++() {
+                    ++current;
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    Iterator temp = *this;
+                    ++(*this);
+                    return temp;
+                }
+
+                bool operator==(const Iterator& other) const {
+                    return current == other.current;
+                }
+
+                bool operator!=(const Iterator& other) const {
+                    return !(*this == other);
+                }
+            };
+
+            TransformView(Base base, Function function)
+                    : base(std::move(base)), function(std::move(function)) {}
+
+            Iterator begin() const {
+                return Iterator(base.begin(), &function);
+            }
+
+            Iterator end() const {
+                return Iterator(base.end(), &function);
+            }
+        };
+
+        // The first count elements of base (fewer if base is shorter)
+        template<typename Base>
+        class TakeView {
+        private:
+            Base base;
+            size_t count;
+
+        public:
+            class Iterator {
+            public:
+                using BaseIterator = IteratorOf<Base>;
+                using iterator_category = ForwardIfBase<BaseIterator>;
+                using value_type = typename std::iterator_traits<BaseIterator>::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = typename std::iterator_traits<BaseIterator>::pointer;
+                using reference = typename std::iterator_traits<BaseIterator>::reference;
+
+            private:
+                BaseIterator current;
+                size_t remaining;  // Elements still to take; 0 at the end
+
+            public:
+                Iterator() : remaining(0) {}
+
+                Iterator(BaseIterator current, size_t remaining)
+                        : current(current), remaining(remaining) {}
+
+                reference operator*() const {
+                    return *current;
+                }
+
+                Iterator& operator++() {
+                    ++current;
+                    --remaining;
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    Iterator temp = *this;
+                    ++(*this);
+                    return temp;
+                }
+
+                // At the end once count elements are taken or base runs out
+                bool operator==(const Iterator& other) const {
+                    return remaining == other.remaining || current == other.current;
+                }
+
+                bool operator!=(const Iterator& other) const {
+                    return !(*this == other);
+                }
+            };
+
+            TakeView(Base base, size_t count)
+                    : base(std::move(base)), count(count) {}
+
+            Iterator begin() const {
+                return Iterator(base.begin(), count);
+            }
+
+            Iterator end() const {
+                return Iterator(base.end(), 0);
+            }
+        };
+
+        // Every step-th element of base, starting with the first
+        template<typename Base>
+        class StrideView {
+        private:
+            Base base;
+            size_t step;
+
+        public:
+            class Iterator {
+            public:
+                using BaseIterator = IteratorOf<Base>;
+                using iterator_category = ForwardIfBase<BaseIterator>;
+                using value_type = typename std::iterator_traits<BaseIterator>::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = typename std::iterator_traits<BaseIterator>::pointer;
+                using reference = typename std::iterator_traits<BaseIterator>::reference;
+
+            private:
+                BaseIterator current;
+                BaseIterator last;
+                size_t step;
+
+            public:
+                Iterator() : step(1) {}
+
+                Iterator(BaseIterator current, BaseIterator last, size_t step)
+                        : current(current), last(last), step(step) {}
+
+                reference operator*() const {
+                    return *current;
+                }
+
+                // O(1) over random access views, else step increments; never passes last
+                Iterator& operator++() {
+                    using Category = typename std::iterator_traits<BaseIterator>::iterator_category;
+                    if constexpr (std::is_base_of<std::random_access_iterator_tag, Category>::value) {
+                        current += std::min<difference_type>(static_cast<difference_type>(step), last - current);
+                    } else {
+                        for (size_t s = 0; s < step && current != last; ++s) {
+                            ++current;
+                        }
+                    }
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    Iterator temp = *this;
+                    ++(*this);
+                    return temp;
+                }
+
+                bool operator==(const Iterator& other) const {
+                    return current == other.current;
+                }
+
+                bool operator!=(const Iterator& other) const {
+                    return !(*this == other);
+                }
+            };
+
+            StrideView(Base base, size_t step)
+                    : base(std::move(base)), step(step) {}
+
+            Iterator begin() const {
+                return Iterator(base.begin(), base.end(), step);
+            }
+
+            Iterator end() const {
+                return Iterator(base.end(), base.end(), step);
+            }
+        };
+
+        // Right-hand side of range | adaptor: make(range) builds the adapted view
+        template<typename Make>
+        struct Adaptor {
+            Make make;
+        };
+
+        template<typename Make>
+        Adaptor<Make> makeAdaptor(Make make) {
+            return Adaptor<Make>{std::move(make)};
+        }
+
+        template<typename Range, typename Make>
+        auto operator|(Range&& range, const Adaptor<Make>& adaptor) {
+            return adaptor.make(std::forward<Range>(range));
+        }
+
+        // Keeps the elements for which pred(element) is true
+        template<typename Pred>
+        auto filter(Pred pred) {
+            return makeAdaptor([pred](auto&& range) {
+                using Base = Stored<decltype(range)>;
+                return FilterView<Base, Pred>(Base(std::forward<decltype(range)>(range)), pred);
+            });
+        }
+
+        // Replaces each element with function(element)
+        template<typename Function>
+        auto transform(Function function) {
+            return makeAdaptor([function](auto&& range) {
+                using Base = Stored<decltype(range)>;
+                return TransformView<Base, Function>(Base(std::forward<decltype(range)>(range)), function);
+            });
+        }
+
+        // Stops after count elements
+        inline auto take(size_t count) {
+            return makeAdaptor([count](auto&& range) {
+                using Base = Stored<decltype(range)>;
+                return TakeView<Base>(Base(std::forward<decltype(range)>(range)), count);
+            });
+        }
+
+        // Keeps every step-th element; throws std::invalid_argument if step is 0
+        inline auto stride(size_t step) {
+            if (step == 0) {
+                throw std::invalid_argument("Stride step must be positive.");
+            }
+            return makeAdaptor([step](auto&& range) {
+                using Base = Stored<decltype(range)>;
+                return StrideView<Base>(Base(std::forward<decltype(range)>(range)), step);
+            });
+        }
+
+    } // namespace adaptors
+
+} // namespace genericContainer
+
+#endif // EX4_ADAPTORS_HPP
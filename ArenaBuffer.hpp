@@ -0,0 +1,102 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_ARENABUFFER_HPP
+#define EX4_ARENABUFFER_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <cstddef>
+
+namespace genericContainer {
+
+    // Fixed-capacity array allocated from a std::pmr::memory_resource – the element
+    // store of arena-backed views. Ranges are copied in bulk (memmove for trivially
+    // copyable T); std::pmr::vector constructs its elements one at a time instead.
+    template<typename T>
+    class ArenaBuffer {
+    private:
+        std::pmr::memory_resource* resource;
+        T* items;
+        size_t count;
+        size_t capacity;
+
+        void release() {
+            if (items) {
+                std::destroy_n(items, count);
+                resource->deallocate(items, capacity * sizeof(T), alignof(T));
+            }
+        }
+
+    public:
+        // Empty buffer with room for capacity elements
+        explicit ArenaBuffer(size_t capacity = 0,
+                             std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+                : resource(resource), items(nullptr), count(0), capacity(capacity) {
+            if (capacity > 0) {
+                items = static_cast<T*>(resource->allocate(capacity * sizeof(T), alignof(T)));
+            }
+        }
+
+        // Copies allocate from the same resource
+        ArenaBuffer(const ArenaBuffer& other)
+                : ArenaBuffer(other.count, other.resource) {
+            append(other.items, other.items + other.count);
+        }
+
+        ArenaBuffer(ArenaBuffer&& other) noexcept
+                : resource(other.resource), items(other.items), count(other.count), capacity(other.capacity) {
+            other.items = nullptr;
+            other.count = 0;
+            other.capacity = 0;
+        }
+
+        ArenaBuffer& operator=(ArenaBuffer other) noexcept {
+            std::swap(resource, other.resource);
+            std::swap(items, other.items);
+            std::swap(count, other.count);
+            std::swap(capacity, other.capacity);
+            return *this;
+        }
+
+        ~ArenaBuffer() {
+            release();
+        }
+
+        // Appends one element (the capacity must allow it)
+        void push_back(const T& item) {
+            ::new (static_cast<void*>(items + count)) T(item);
+            ++count;
+        }
+
+        // Appends [first, last) in one bulk copy (the capacity must allow it)
+        template<typename InputIt>
+        void append(InputIt first, InputIt last) {
+            T* end = std::uninitialized_copy(first, last, items + count);
+            count = static_cast<size_t>(end - items);
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        const T& operator[](size_t i) const {
+            return items[i];
+        }
+
+        const T* begin() const {
+            return items;
+        }
+
+        const T* end() const {
+            return items + count;
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_ARENABUFFER_HPP
@@ -4,46 +4,70 @@
 #define EX4_ASCENDINGORDER_HPP
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <algorithm>
 #include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
 
 namespace genericContainer {
 
     // Template class for iterating through a container in ascending order
-    template<typename T>
+    template<typename T, typename Checks = DefaultIteratorChecks>
     class AscendingOrder {
     private:
-        std::vector<T> sortedData; // Holds a sorted copy of the original data
+        std::shared_ptr<const SortedIndex<T>> sortedData; // Sort index of the original data (may be shared)
 
     public:
-        // Nested iterator class
+        // Nested iterator class – a standard random access iterator
         class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
         private:
-            const std::vector<T>* data; // Pointer to the sorted data
-            size_t index;               // Current index in the data
+            const SortedIndex<T>* data;  // Pointer to the sort index
+            size_t index;                // Current index in the data
+            GenerationGuard guard;       // Validity of a permutation index
+
+            // Underlying position of the element visited at step p
+            size_t position(size_t p) const {
+                return p;
+            }
 
         public:
+            // Default constructor – singular iterator, only assignable
+            Iterator() : data(nullptr), index(0) {}
+
             // Constructor
-            Iterator(const std::vector<T>* data, size_t index)
-                    : data(data), index(index) {
-                if (!data) {
-                    throw std::invalid_argument("Null data pointer passed to Iterator.");
-                }
+            Iterator(const SortedIndex<T>* data, size_t index)
+                    : data(data), index(index),
+                      guard(data ? data->generationGuard() : GenerationGuard()) {
+                failIf<Checks, std::invalid_argument>(!data, "Null data pointer passed to Iterator.");
             }
 
             // Dereference operator
-            const T& operator*() const {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Attempted to dereference out-of-bounds iterator.");
-                }
-                return data->at(index);
+            reference operator*() const {
+                guard.check<Checks>();
+                failIf<Checks, std::out_of_range>(index >= data->size(),
+                                                  "Attempted to dereference out-of-bounds iterator.");
+                return (*data)[position(index)];
+            }
+
+            // Member access (it->member)
+            pointer operator->() const {
+                return &**this;
             }
 
             // Prefix increment (++it)
             Iterator& operator++() {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Cannot increment beyond end of data.");
-                }
+                failIf<Checks, std::out_of_range>(index >= data->size(),
+                                                  "Cannot increment beyond end of data.");
                 ++index;
                 return *this;
             }
@@ -57,9 +81,7 @@ namespace genericContainer {
 
             // Prefix decrement (--it)
             Iterator& operator--() {
-                if (index == 0) {
-                    throw std::out_of_range("Cannot decrement below zero.");
-                }
+                failIf<Checks, std::out_of_range>(index == 0, "Cannot decrement below zero.");
                 --index;
                 return *this;
             }
@@ -71,73 +93,102 @@ namespace genericContainer {
                 return temp;
             }
 
-            // Indexing (it[n])
-            const T& operator[](size_t offset) const {
-                if (index + offset >= data->size()) {
-                    throw std::out_of_range("Random access out of range.");
-                }
-                return data->at(index + offset);
+            // Random access (it[n]) – O(1), n may be negative
+            reference operator[](difference_type offset) const {
+                guard.check<Checks>();
+                difference_type target = static_cast<difference_type>(index) + offset;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) >= data->size(),
+                                                  "Random access out of range.");
+                return (*data)[position(static_cast<size_t>(target))];
+            }
+
+            // Add and assign (it += n) – O(1), n may be negative
+            Iterator& operator+=(difference_type n) {
+                difference_type target = static_cast<difference_type>(index) + n;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) > data->size(),
+                                                  "Iterator += out of range.");
+                index = static_cast<size_t>(target);
+                return *this;
             }
 
-            // Add offset (it + n)
-            Iterator operator+(int n) const {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator + offset out of range.");
-                }
-                return Iterator(data, index + n);
+            // Subtract and assign (it -= n)
+            Iterator& operator-=(difference_type n) {
+                return *this += -n;
             }
 
-            // Subtract offset (it - n)
-            Iterator operator-(int n) const {
-                if (n > index) {
-                    throw std::out_of_range("Iterator - offset out of range.");
-                }
-                return Iterator(data, index - n);
+            // Jump forward (it + n)
+            Iterator operator+(difference_type n) const {
+                Iterator result = *this;
+                result += n;
+                return result;
             }
 
-            // Add and assign (it += n)
-            Iterator& operator+=(int n) {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator += out of range.");
-                }
-                index += n;
-                return *this;
+            // Jump forward (n + it)
+            friend Iterator operator+(difference_type n, const Iterator& it) {
+                return it + n;
             }
 
-            // Subtract and assign (it -= n)
-            Iterator& operator-=(int n) {
-                if (n > index) {
-                    throw std::out_of_range("Iterator -= out of range.");
-                }
-                index -= n;
-                return *this;
+            // Jump backward (it - n)
+            Iterator operator-(difference_type n) const {
+                Iterator result = *this;
+                result -= n;
+                return result;
             }
 
-            // Inequality comparison
-            bool operator!=(const Iterator& other) const {
-                return index != other.index || data != other.data;
+            // Distance between two iterators of the same view (it - other) – O(1)
+            difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
             }
 
-            // Equality comparison (optional)
+            // Equality comparison
             bool operator==(const Iterator& other) const {
                 return index == other.index && data == other.data;
             }
+
+            // Inequality comparison
+            bool operator!=(const Iterator& other) const {
+                return !(*this == other);
+            }
+
+            // Ordering – iterators of the same view compare by step
+            bool operator<(const Iterator& other) const {
+                return index < other.index;
+            }
+
+            bool operator>(const Iterator& other) const {
+                return other < *this;
+            }
+
+            bool operator<=(const Iterator& other) const {
+                return !(other < *this);
+            }
+
+            bool operator>=(const Iterator& other) const {
+                return !(*this < other);
+            }
         };
 
         // Constructor: copies and sorts the original data
         AscendingOrder(const std::vector<T>& original) {
-            sortedData = original;
-            std::sort(sortedData.begin(), sortedData.end());
+            sortedData = std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(original));
+        }
+
+        // Constructor: shares an existing sort index (no copy, no sort)
+        explicit AscendingOrder(std::shared_ptr<const SortedIndex<T>> sorted)
+                : sortedData(std::move(sorted)) {
+            if (!sortedData) {
+                throw std::invalid_argument("Null sorted data passed to AscendingOrder.");
+            }
         }
 
         // Returns an iterator to the beginning of the sorted data
         Iterator begin() const {
-            return Iterator(&sortedData, 0);
+            return Iterator(sortedData.get(), 0);
         }
 
         // Returns an iterator to the end (one past the last element)
         Iterator end() const {
-            return Iterator(&sortedData, sortedData.size());
+            return Iterator(sortedData.get(), sortedData->size());
         }
     };
 
@@ -0,0 +1,226 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_BINARYFORMAT_HPP
+#define EX4_BINARYFORMAT_HPP
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SortedIndex.hpp"
+
+namespace genericContainer {
+
+    namespace binary {
+
+        constexpr char magic[8] = {'M', 'Y', 'C', 'O', 'N', 'T', 'N', 'R'};
+        constexpr uint32_t formatVersion = 1;
+        constexpr uint32_t byteOrderMark = 0x01020304;  // Reads back differently on the other endianness
+        constexpr uint64_t dataOffset = 64;             // Elements start here, 64-byte aligned
+
+        // Element category stored in the file, so an int file is not read as float
+        template<typename T>
+        constexpr uint32_t elementKind() {
+            return std::is_floating_point<T>::value ? 3
+                 : std::is_integral<T>::value ? (std::is_signed<T>::value ? 1 : 2)
+                 : 0;
+        }
+
+        // File layout: this header, count elements at dataOffset, then (optionally) the
+        // ascending permutation at indexOffset – 4-byte entries when count fits, else 8
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint32_t elementSize;
+            uint32_t elementAlign;
+            uint32_t elementKind;
+            uint32_t indexWidth;   // Bytes per permutation entry, 0 = no permutation
+            uint64_t count;
+            uint64_t dataOffset;
+            uint64_t indexOffset;
+            uint64_t reserved;
+        };
+        static_assert(sizeof(FileHeader) == dataOffset, "FileHeader must fill the space before the elements");
+
+        // Writes count elements at items (and their ascending permutation if withIndex) to path
+        template<typename T>
+        void writeFile(const std::string& path, const T* items, size_t count, bool withIndex) {
+            static_assert(std::is_trivially_copyable<T>::value, "Binary files hold trivially copyable types only");
+            static_assert(alignof(T) <= dataOffset, "Element alignment exceeds the file's data alignment");
+
+            FileHeader header = {};
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.version = formatVersion;
+            header.byteOrder = byteOrderMark;
+            header.elementSize = sizeof(T);
+            header.elementAlign = alignof(T);
+            header.elementKind = elementKind<T>();
+            header.count = count;
+            header.dataOffset = dataOffset;
+            uint64_t dataEnd = dataOffset + count * sizeof(T);
+            if (withIndex) {
+                header.indexWidth = count <= std::numeric_limits<uint32_t>::max() ? 4 : 8;
+                header.indexOffset = (dataEnd + 7) / 8 * 8;
+            }
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::system_error(errno, std::generic_category(), "Cannot create " + path);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(items), static_cast<std::streamsize>(count * sizeof(T)));
+            if (withIndex) {
+                const char padding[8] = {};
+                out.write(padding, static_cast<std::streamsize>(header.indexOffset - dataEnd));
+                if (header.indexWidth == 4) {
+                    std::vector<uint32_t> order;
+                    SortedIndex<T>::sortPositions(items, count, order, SortOptions());
+                    out.write(reinterpret_cast<const char*>(order.data()),
+                              static_cast<std::streamsize>(order.size() * sizeof(uint32_t)));
+                } else {
+                    std::vector<uint64_t> order;
+                    SortedIndex<T>::sortPositions(items, count, order, SortOptions());
+                    out.write(reinterpret_cast<const char*>(order.data()),
+                              static_cast<std::streamsize>(order.size() * sizeof(uint64_t)));
+                }
+            }
+            out.close();
+            if (!out) {
+                throw std::runtime_error("Failed to write " + path);
+            }
+        }
+
+        // Read-only memory mapping of a container file, checked against T on construction
+        class MappedFile {
+        private:
+            void* address;
+            size_t length;
+
+            const FileHeader& header() const {
+                return *static_cast<const FileHeader*>(address);
+            }
+
+            // Throws std::runtime_error unless the file holds T elements in this format
+            template<typename T>
+            void validate(const std::string& path) const {
+                auto fail = [&path](const std::string& why) {
+                    throw std::runtime_error("Invalid container file " + path + ": " + why);
+                };
+                if (length < sizeof(FileHeader) || std::memcmp(header().magic, magic, sizeof(magic)) != 0) {
+                    fail("not a container file");
+                }
+                if (header().byteOrder != byteOrderMark) {
+                    fail("written on a machine of different endianness");
+                }
+                if (header().version != formatVersion) {
+                    fail("unsupported version " + std::to_string(header().version));
+                }
+                if (header().elementSize != sizeof(T) || header().elementAlign != alignof(T) ||
+                    header().elementKind != elementKind<T>()) {
+                    fail("element type does not match");
+                }
+                uint64_t count = header().count;
+                if (header().dataOffset != dataOffset || count > (length - dataOffset) / sizeof(T)) {
+                    fail("truncated elements");
+                }
+                if (header().indexWidth != 0) {
+                    uint64_t width = header().indexWidth;
+                    if ((width != 4 && width != 8) || header().indexOffset % width != 0 ||
+                        header().indexOffset < dataOffset + count * sizeof(T) || header().indexOffset > length ||
+                        count > (length - header().indexOffset) / width) {
+                        fail("truncated permutation");
+                    }
+                }
+            }
+
+        public:
+            template<typename T>
+            static MappedFile open(const std::string& path) {
+                MappedFile file(path);
+                file.validate<T>(path);
+                return file;
+            }
+
+            explicit MappedFile(const std::string& path) : address(nullptr), length(0) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+                }
+                struct stat info;
+                if (::fstat(fd, &info) != 0) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "Cannot stat " + path);
+                }
+                length = static_cast<size_t>(info.st_size);
+                if (length > 0) {
+                    address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                }
+                int error = errno;
+                ::close(fd);
+                if (address == MAP_FAILED) {
+                    address = nullptr;
+                    throw std::system_error(error, std::generic_category(), "Cannot map " + path);
+                }
+            }
+
+            MappedFile(MappedFile&& other) noexcept : address(other.address), length(other.length) {
+                other.address = nullptr;
+                other.length = 0;
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile& operator=(MappedFile&&) = delete;
+
+            ~MappedFile() {
+                if (address) {
+                    ::munmap(address, length);
+                }
+            }
+
+            size_t size() const {
+                return static_cast<size_t>(header().count);
+            }
+
+            // The elements (T as given to open)
+            template<typename T>
+            const T* elements() const {
+                return reinterpret_cast<const T*>(static_cast<const char*>(address) + dataOffset);
+            }
+
+            bool hasPermutation() const {
+                return header().indexWidth != 0;
+            }
+
+            // Builds the sort index from the stored permutation (no sort); data is where the
+            // elements now live – the mapping itself, or a copy of it
+            template<typename T>
+            SortedIndex<T> permutationIndex(const T* data, const size_t* generation, const SortOptions& options,
+                                            std::shared_ptr<const void> owner = nullptr) const {
+                const char* order = static_cast<const char*>(address) + header().indexOffset;
+                if (header().indexWidth == 4) {
+                    return SortedIndex<T>::fromPermutation(data, reinterpret_cast<const uint32_t*>(order), size(),
+                                                           generation, options, std::move(owner));
+                }
+                return SortedIndex<T>::fromPermutation(data, reinterpret_cast<const uint64_t*>(order), size(),
+                                                       generation, options, std::move(owner));
+            }
+        };
+
+    } // namespace binary
+
+} // namespace genericContainer
+
+#endif // EX4_BINARYFORMAT_HPP
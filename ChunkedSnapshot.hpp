@@ -0,0 +1,75 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_CHUNKEDSNAPSHOT_HPP
+#define EX4_CHUNKEDSNAPSHOT_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace genericContainer {
+
+    // Immutable, reference-counted sequence of a ChunkedStorage's elements at one moment.
+    // Copying a snapshot is O(1); the storage copies a chunk before changing it while any
+    // snapshot still refers to it, so a snapshot never changes.
+    template<typename T>
+    class ChunkedSnapshot {
+    public:
+        static constexpr size_t chunkBits = 12;
+        static constexpr size_t chunkSize = size_t(1) << chunkBits;  // Elements per full chunk
+
+        using Chunk = std::vector<T>;
+        using Table = std::vector<std::shared_ptr<Chunk>>;  // Every chunk is full except the last
+
+    private:
+        std::shared_ptr<const Table> table;
+        size_t count;
+
+    public:
+        ChunkedSnapshot() : count(0) {}
+
+        ChunkedSnapshot(std::shared_ptr<const Table> table, size_t count)
+                : table(std::move(table)), count(count) {}
+
+        size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        // Element i – O(1), two indirections
+        const T& operator[](size_t i) const {
+            return (*(*table)[i >> chunkBits])[i & (chunkSize - 1)];
+        }
+
+        // Calls f on every element in order
+        template<typename Function>
+        void forEach(Function f) const {
+            if (!table) {
+                return;
+            }
+            for (const auto& chunk : *table) {
+                for (const T& item : *chunk) {
+                    f(item);
+                }
+            }
+        }
+
+        // Copies the elements into one vector
+        std::vector<T> toVector() const {
+            std::vector<T> result;
+            result.reserve(count);
+            if (table) {
+                for (const auto& chunk : *table) {
+                    result.insert(result.end(), chunk->begin(), chunk->end());
+                }
+            }
+            return result;
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_CHUNKEDSNAPSHOT_HPP
@@ -0,0 +1,173 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_CHUNKEDSTORAGE_HPP
+#define EX4_CHUNKEDSTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include "SortedIndex.hpp"
+#include "ChunkedSnapshot.hpp"
+
+namespace genericContainer {
+
+    // Copy-on-write MyContainer storage policy for read-heavy workloads.
+    // Elements live in fixed-size chunks shared with the snapshots handed to views, so
+    // order(), reverseOrder(), middleOutOrder() and copies of the container are O(1).
+    // A change after a snapshot copies the chunk table and only the chunks it touches.
+    template<typename T>
+    class ChunkedStorage {
+    private:
+        using Chunk = typename ChunkedSnapshot<T>::Chunk;
+        using Table = typename ChunkedSnapshot<T>::Table;
+        static constexpr size_t chunkSize = ChunkedSnapshot<T>::chunkSize;
+
+        std::shared_ptr<Table> table;  // Shared with snapshots (and container copies) until the next change
+        size_t count = 0;
+
+        // Element i
+        const T& at(size_t i) const {
+            return (*(*table)[i / chunkSize])[i % chunkSize];
+        }
+
+        // The table, copied first if a snapshot still refers to it
+        Table& writableTable() {
+            if (!table) {
+                table = std::make_shared<Table>();
+            } else if (table.use_count() > 1) {
+                table = std::make_shared<Table>(*table);
+            }
+            return *table;
+        }
+
+        // Last chunk of a writable table, copied first if an older table still refers to it
+        Chunk& writableBack(Table& chunks) {
+            if (chunks.back().use_count() > 1) {
+                chunks.back() = std::make_shared<Chunk>(*chunks.back());
+            }
+            return *chunks.back();
+        }
+
+        template<typename... Args>
+        void append(Args&&... args) {
+            Table& chunks = writableTable();
+            if (count % chunkSize == 0) {
+                chunks.push_back(std::make_shared<Chunk>());
+            }
+            writableBack(chunks).emplace_back(std::forward<Args>(args)...);
+            ++count;
+        }
+
+    public:
+        // Borrowing views get a snapshot instead – the elements are not contiguous
+        static constexpr bool contiguous = false;
+
+        // sortIndex may sort (and spill under a memory limit)
+        static constexpr bool presorted = false;
+
+        // What items() returns – an O(1) snapshot
+        using Items = ChunkedSnapshot<T>;
+
+        ChunkedStorage() = default;
+
+        // Constructor – copies the range [first, last)
+        template<typename InputIt>
+        ChunkedStorage(InputIt first, InputIt last) {
+            addRange(first, last);
+        }
+
+        void add(const T& item) {
+            append(item);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            append(std::forward<Args>(args)...);
+        }
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                append(*first);
+            }
+        }
+
+        // Reserves room in the chunk table (chunks themselves are allocated as they fill)
+        void reserve(size_t capacity) {
+            writableTable().reserve((capacity + chunkSize - 1) / chunkSize);
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        // Chunks before the first removed element stay shared; the rest are rebuilt from
+        // the survivors. pred runs once per element. Returns the number removed.
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
+            size_t first = 0;
+            while (first < count && !pred(at(first))) {
+                ++first;
+            }
+            if (first == count) {
+                return 0;
+            }
+
+            Table& chunks = writableTable();
+            size_t firstChunk = first / chunkSize;
+            Table rebuilt(chunks.begin(), chunks.begin() + static_cast<std::ptrdiff_t>(firstChunk));
+            size_t kept = firstChunk * chunkSize;
+            std::shared_ptr<Chunk> out;
+            for (size_t i = kept; i < count; ++i) {
+                const T& item = at(i);
+                if (i == first || (i > first && pred(item))) {
+                    continue;
+                }
+                if (!out || out->size() == chunkSize) {
+                    out = std::make_shared<Chunk>();
+                    out->reserve(chunkSize);
+                    rebuilt.push_back(out);
+                }
+                out->push_back(item);
+                ++kept;
+            }
+
+            size_t removed = count - kept;
+            chunks.swap(rebuilt);
+            count = kept;
+            return removed;
+        }
+
+        // Removes every element equal to item
+        size_t removeValue(const T& item) {
+            return removeIf([&item](const T& val) { return val == item; });
+        }
+
+        // Removes every element equal to one of sortedValues (sorted, distinct)
+        size_t removeValues(const std::vector<T>& sortedValues) {
+            return removeIf([&sortedValues](const T& val) {
+                return std::binary_search(sortedValues.begin(), sortedValues.end(), val);
+            });
+        }
+
+        // Snapshot of the elements in insertion order – O(1)
+        ChunkedSnapshot<T> items() const {
+            return ChunkedSnapshot<T>(table, count);
+        }
+
+        // Calls f on every element in insertion order
+        template<typename Function>
+        void forEach(Function f) const {
+            items().forEach(f);
+        }
+
+        // Sorts a copy of the values – a permutation index needs contiguous storage
+        std::shared_ptr<const SortedIndex<T>> sortIndex(const size_t*, const SortOptions& options) const {
+            return std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(items().toVector(), options));
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_CHUNKEDSTORAGE_HPP
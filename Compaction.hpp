@@ -0,0 +1,196 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_COMPACTION_HPP
+#define EX4_COMPACTION_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "SimdSupport.hpp"
+
+namespace genericContainer {
+
+    namespace compaction {
+
+        // True for element types the SIMD kernels handle: 4- and 8-byte integers,
+        // float and double (comparisons follow ==, so NaN never matches and -0.0 == +0.0)
+        template<typename T>
+        struct Vectorizable
+                : std::integral_constant<bool,
+                        std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                        (sizeof(T) == 4 || sizeof(T) == 8) &&
+                        (std::is_integral<T>::value || std::is_same<T, float>::value ||
+                         std::is_same<T, double>::value)> {};
+
+        // Reference path: moves every element != value to the front, keeping order.
+        // Returns the number removed; survivors occupy [0, n - removed).
+        template<typename T>
+        size_t removeEqualScalar(T* data, size_t n, const T& value) {
+            return static_cast<size_t>((data + n) - std::remove(data, data + n, value));
+        }
+
+#ifdef MYCONTAINER_SIMD_X86
+
+        // Permutation tables for _mm256_permutevar8x32_epi32: row keep lists the 32-bit
+        // lanes to keep, packed to the front. CompressTable<8> packs 8 x 32-bit elements,
+        // CompressTable<4> packs 4 x 64-bit elements (two 32-bit lanes each).
+        template<int Lanes>
+        struct CompressTable {
+            alignas(32) uint32_t rows[1 << Lanes][8] = {};
+
+            constexpr CompressTable() {
+                constexpr int width = 8 / Lanes;
+                for (int keep = 0; keep < (1 << Lanes); ++keep) {
+                    int out = 0;
+                    for (int lane = 0; lane < Lanes; ++lane) {
+                        if (keep & (1 << lane)) {
+                            for (int half = 0; half < width; ++half) {
+                                rows[keep][out++] = static_cast<uint32_t>(lane * width + half);
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        template<int Lanes>
+        inline constexpr CompressTable<Lanes> compressTable{};
+
+        // Bit i set when lane i of a 32-byte block equals value
+        template<typename T>
+        __attribute__((target("avx2")))
+        inline unsigned matchMaskAvx2(__m256i block, const T& value) {
+            if constexpr (std::is_same<T, float>::value) {
+                return static_cast<unsigned>(_mm256_movemask_ps(
+                        _mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_set1_ps(value), _CMP_EQ_OQ)));
+            } else if constexpr (std::is_same<T, double>::value) {
+                return static_cast<unsigned>(_mm256_movemask_pd(
+                        _mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_set1_pd(value), _CMP_EQ_OQ)));
+            } else if constexpr (sizeof(T) == 4) {
+                int32_t bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                return static_cast<unsigned>(_mm256_movemask_ps(
+                        _mm256_castsi256_ps(_mm256_cmpeq_epi32(block, _mm256_set1_epi32(bits)))));
+            } else {
+                long long bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                return static_cast<unsigned>(_mm256_movemask_pd(
+                        _mm256_castsi256_pd(_mm256_cmpeq_epi64(block, _mm256_set1_epi64x(bits)))));
+            }
+        }
+
+        // AVX2 kernel: compares 8 (32-bit) or 4 (64-bit) lanes per step and packs the
+        // survivors with one table-driven permute. Writes never pass the read position,
+        // so the full-width store only clobbers lanes that were already loaded.
+        template<typename T>
+        __attribute__((target("avx2")))
+        size_t removeEqualAvx2(T* data, size_t n, const T& value) {
+            constexpr size_t lanes = 32 / sizeof(T);
+            constexpr unsigned allLanes = (1u << lanes) - 1;
+            const auto& table = compressTable<static_cast<int>(lanes)>;
+            size_t out = 0;
+            size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                unsigned keep = ~matchMaskAvx2(block, value) & allLanes;
+                if (keep == allLanes) {
+                    if (out != i) {
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + out), block);
+                    }
+                    out += lanes;
+                    continue;
+                }
+                __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.rows[keep]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + out),
+                                    _mm256_permutevar8x32_epi32(block, order));
+                out += static_cast<size_t>(__builtin_popcount(keep));
+            }
+            for (; i < n; ++i) {
+                if (!(data[i] == value)) {
+                    data[out++] = data[i];
+                }
+            }
+            return n - out;
+        }
+
+        // Bit i set when lane i of a 16-byte block equals value (SSE2 only)
+        template<typename T>
+        inline unsigned matchMaskSse2(__m128i block, const T& value) {
+            if constexpr (std::is_same<T, float>::value) {
+                return static_cast<unsigned>(_mm_movemask_ps(
+                        _mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_set1_ps(value))));
+            } else if constexpr (std::is_same<T, double>::value) {
+                return static_cast<unsigned>(_mm_movemask_pd(
+                        _mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_set1_pd(value))));
+            } else if constexpr (sizeof(T) == 4) {
+                int32_t bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                return static_cast<unsigned>(_mm_movemask_ps(
+                        _mm_castsi128_ps(_mm_cmpeq_epi32(block, _mm_set1_epi32(bits)))));
+            } else {
+                // No 64-bit compare before SSE4.1: both 32-bit halves must match
+                int32_t halves[2];
+                std::memcpy(halves, &value, sizeof(T));
+                __m128i eq = _mm_cmpeq_epi32(block, _mm_set_epi32(halves[1], halves[0], halves[1], halves[0]));
+                eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+            }
+        }
+
+        // SSE2 kernel: SSE2 has no variable shuffle, so blocks without a match are moved
+        // whole and only blocks with a match are packed lane by lane
+        template<typename T>
+        size_t removeEqualSse2(T* data, size_t n, const T& value) {
+            constexpr size_t lanes = 16 / sizeof(T);
+            size_t out = 0;
+            size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                unsigned matched = matchMaskSse2(block, value);
+                if (matched == 0) {
+                    if (out != i) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + out), block);
+                    }
+                    out += lanes;
+                    continue;
+                }
+                alignas(16) T lanesOf[lanes];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanesOf), block);
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    data[out] = lanesOf[lane];
+                    out += ((matched >> lane) & 1u) ^ 1u;
+                }
+            }
+            for (; i < n; ++i) {
+                if (!(data[i] == value)) {
+                    data[out++] = data[i];
+                }
+            }
+            return n - out;
+        }
+
+#endif // MYCONTAINER_SIMD_X86
+
+    } // namespace compaction
+
+    // Removes every element equal to value from [data, data + n) in place, keeping order.
+    // Returns the number removed. Arithmetic types use AVX2 when the CPU has it, SSE2
+    // otherwise; everything else uses std::remove.
+    template<typename T>
+    size_t removeEqual(T* data, size_t n, const T& value) {
+#ifdef MYCONTAINER_SIMD_X86
+        if constexpr (compaction::Vectorizable<T>::value) {
+            if (cpuHasAvx2()) {
+                return compaction::removeEqualAvx2(data, n, value);
+            }
+            return compaction::removeEqualSse2(data, n, value);
+        }
+#endif
+        return compaction::removeEqualScalar(data, n, value);
+    }
+
+} // namespace genericContainer
+
+#endif // EX4_COMPACTION_HPP
@@ -0,0 +1,190 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_CONCURRENTCONTAINER_HPP
+#define EX4_CONCURRENTCONTAINER_HPP
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include "MyContainer.hpp"
+
+namespace genericContainer {
+
+    // Append-only container for many writer threads. Each thread adds to its own shard
+    // (one lock per shard, so add is uncontended while threads <= shards), and readers
+    // build views from a merged snapshot. Removal and sorting options live on the
+    // MyContainer returned by snapshot().
+    template<typename T = int>
+    class ConcurrentContainer {
+    private:
+        // Capacity of a shard's first chunk; every later chunk doubles it
+        static constexpr size_t firstChunk = 1024;
+
+        // One writer's buffer. Chunks are reserved up front and never grow past their
+        // capacity, so elements never move once added.
+        struct alignas(64) Shard {
+            std::mutex lock;
+            std::vector<std::vector<T>> chunks;
+            size_t count = 0;
+        };
+
+        // Elements [items, items + count) of one chunk, captured by a snapshot
+        struct Segment {
+            const T* items;
+            size_t count;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        size_t shardCount;
+
+        // Shard of the calling thread – threads are spread round robin over the shards
+        Shard& localShard() const {
+            static std::atomic<size_t> nextThread{0};
+            thread_local size_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+            return shards[thread % shardCount];
+        }
+
+        // Constructs one element at the end of shard (its lock must be held)
+        template<typename... Args>
+        static void append(Shard& shard, Args&&... args) {
+            if (shard.chunks.empty() || shard.chunks.back().size() == shard.chunks.back().capacity()) {
+                size_t capacity = shard.chunks.empty() ? firstChunk : shard.chunks.back().capacity() * 2;
+                shard.chunks.emplace_back();
+                shard.chunks.back().reserve(capacity);
+            }
+            shard.chunks.back().emplace_back(std::forward<Args>(args)...);
+            ++shard.count;
+        }
+
+        // Records each shard's chunks under that shard's lock alone, one shard after
+        // another, so a writer only ever waits for its own shard to be recorded and never
+        // for the copy that follows: elements before the cut are never written again.
+        std::vector<Segment> segments(size_t& total) const {
+            std::vector<Segment> result;
+            total = 0;
+            for (size_t s = 0; s < shardCount; ++s) {
+                std::lock_guard<std::mutex> lock(shards[s].lock);
+                for (const std::vector<T>& chunk : shards[s].chunks) {
+                    result.push_back(Segment{chunk.data(), chunk.size()});
+                }
+                total += shards[s].count;
+            }
+            return result;
+        }
+
+        // Sort index of a fresh copy, handed to the sorted views so they don't copy it again
+        std::shared_ptr<const SortedIndex<T>> sortedItems() const {
+            return std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(items()));
+        }
+
+    public:
+        // buffers = number of shards (0 = one per hardware thread)
+        explicit ConcurrentContainer(size_t buffers = 0)
+                : shardCount(buffers ? buffers : std::max(1u, std::thread::hardware_concurrency())) {
+            shards.reset(new Shard[shardCount]);
+        }
+
+        ConcurrentContainer(const ConcurrentContainer&) = delete;
+        ConcurrentContainer& operator=(const ConcurrentContainer&) = delete;
+
+        // Safe to call from any number of threads at once
+        void add(const T& item) {
+            Shard& shard = localShard();
+            std::lock_guard<std::mutex> lock(shard.lock);
+            append(shard, item);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            Shard& shard = localShard();
+            std::lock_guard<std::mutex> lock(shard.lock);
+            append(shard, std::forward<Args>(args)...);
+        }
+
+        // Adds a whole range under a single lock
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            Shard& shard = localShard();
+            std::lock_guard<std::mutex> lock(shard.lock);
+            for (; first != last; ++first) {
+                append(shard, *first);
+            }
+        }
+
+        // Number of elements added so far
+        size_t size() const {
+            size_t total = 0;
+            for (size_t s = 0; s < shardCount; ++s) {
+                std::lock_guard<std::mutex> lock(shards[s].lock);
+                total += shards[s].count;
+            }
+            return total;
+        }
+
+        // Copy of every element: each shard's elements in the order they were added, shard
+        // after shard. Each shard contributes everything added to it before it was recorded;
+        // writers keep adding while it is copied.
+        std::vector<T> items() const {
+            size_t total;
+            std::vector<Segment> parts = segments(total);
+            std::vector<T> result;
+            result.reserve(total);
+            for (const Segment& part : parts) {
+                result.insert(result.end(), part.items, part.items + part.count);
+            }
+            return result;
+        }
+
+        // Snapshot (cut as for items()) as an ordinary container (for removal, lazy/parallel sorting
+        // and the borrowing views)
+        MyContainer<T> snapshot() const {
+            size_t total;
+            std::vector<Segment> parts = segments(total);
+            MyContainer<T> result;
+            result.reserve(total);
+            for (const Segment& part : parts) {
+                result.addRange(part.items, part.items + part.count);
+            }
+            return result;
+        }
+
+        // Views over a fresh snapshot; they own their data, so they stay valid while
+        // writers continue
+        template<typename Checks = DefaultIteratorChecks>
+        AscendingOrder<T, Checks> ascendingOrder() const {
+            return AscendingOrder<T, Checks>(sortedItems());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        DescendingOrder<T, Checks> descendingOrder() const {
+            return DescendingOrder<T, Checks>(sortedItems());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        SideCrossOrder<T, Checks> sideCrossOrder() const {
+            return SideCrossOrder<T, Checks>(sortedItems());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        ReverseOrder<T, Checks> reverseOrder() const {
+            return ReverseOrder<T, Checks>(items());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        Order<T, Checks> order() const {
+            return Order<T, Checks>(items());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        MiddleOutOrder<T, Checks> middleOutOrder() const {
+            return MiddleOutOrder<T, Checks>(items());
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_CONCURRENTCONTAINER_HPP
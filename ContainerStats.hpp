@@ -0,0 +1,167 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_CONTAINERSTATS_HPP
+#define EX4_CONTAINERSTATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <sstream>
+
+// Process-wide MyContainer counters. Define MYCONTAINER_STATS (or call setEnabled) to
+// collect them; otherwise every recording call is one relaxed load and snapshot() returns
+// zeros. There is one definition of everything here whether or not the macro is defined,
+// so translation units built with and without it can be linked together.
+
+namespace genericContainer {
+namespace stats {
+
+    // Whether counters are collected, shared by every translation unit
+    inline std::atomic<bool> collecting{false};
+
+    inline bool enabled() {
+        return collecting.load(std::memory_order_relaxed);
+    }
+
+    // Switches collection on or off at run time (counts so far are kept)
+    inline void setEnabled(bool on) {
+        collecting.store(on, std::memory_order_relaxed);
+    }
+
+    // What is counted: view constructions per order, sort index builds, removals
+    enum Operation : size_t {
+        AscendingView, DescendingView, SideCrossView, ReverseView, OrderView, MiddleOutView,
+        Sort, Remove, OperationCount
+    };
+
+    inline const char* operationName(size_t op) {
+        static const char* const names[OperationCount] = {
+            "ascendingOrder", "descendingOrder", "sideCrossOrder", "reverseOrder", "order",
+            "middleOutOrder", "sort", "remove"
+        };
+        return names[op];
+    }
+
+    // Totals of one operation. elements: copied into a view, sorted, or the container size
+    // a removal scanned; bytes: allocated for the view copy or the sort index.
+    struct Counter {
+        uint64_t calls = 0;
+        uint64_t elements = 0;
+        uint64_t bytes = 0;
+        uint64_t nanoseconds = 0;  // Wall time inside the call, a view's sort included
+    };
+
+    // Counters read at one moment
+    struct Snapshot {
+        Counter counters[OperationCount];
+
+        const Counter& operator[](Operation op) const {
+            return counters[op];
+        }
+
+        // One line per operation: name calls elements bytes ns
+        std::string toText() const {
+            std::ostringstream out;
+            for (size_t op = 0; op < OperationCount; ++op) {
+                const Counter& c = counters[op];
+                out << operationName(op) << " calls=" << c.calls << " elements=" << c.elements
+                    << " bytes=" << c.bytes << " ns=" << c.nanoseconds << "\n";
+            }
+            return out.str();
+        }
+
+        // {"enabled": ..., "operations": {"<name>": {"calls": ..., ...}, ...}}
+        std::string toJson() const {
+            std::ostringstream out;
+            out << "{\"enabled\": " << (enabled() ? "true" : "false") << ", \"operations\": {";
+            for (size_t op = 0; op < OperationCount; ++op) {
+                const Counter& c = counters[op];
+                out << (op ? ", " : "") << "\"" << operationName(op) << "\": {\"calls\": " << c.calls
+                    << ", \"elements\": " << c.elements << ", \"bytes\": " << c.bytes
+                    << ", \"ns\": " << c.nanoseconds << "}";
+            }
+            out << "}}";
+            return out.str();
+        }
+    };
+
+    // Live counters, updated with relaxed atomics from any thread
+    struct LiveCounter {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> elements{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> nanoseconds{0};
+    };
+
+    inline LiveCounter live[OperationCount];
+
+    inline Snapshot snapshot() {
+        Snapshot result;
+        for (size_t op = 0; op < OperationCount; ++op) {
+            result.counters[op].calls = live[op].calls.load(std::memory_order_relaxed);
+            result.counters[op].elements = live[op].elements.load(std::memory_order_relaxed);
+            result.counters[op].bytes = live[op].bytes.load(std::memory_order_relaxed);
+            result.counters[op].nanoseconds = live[op].nanoseconds.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    inline void reset() {
+        for (auto& c : live) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.elements.store(0, std::memory_order_relaxed);
+            c.bytes.store(0, std::memory_order_relaxed);
+            c.nanoseconds.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Counts one call of op and the time until the scope ends (nothing while not collecting)
+    class Scope {
+    private:
+        LiveCounter* counter;  // Null while not collecting
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Scope(Operation op, size_t elements = 0, size_t bytes = 0)
+                : counter(enabled() ? &live[op] : nullptr) {
+            if (counter) {
+                start = std::chrono::steady_clock::now();
+                counter->calls.fetch_add(1, std::memory_order_relaxed);
+                add(elements, bytes);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Adds to the elements and bytes of this call
+        void add(size_t elements, size_t bytes = 0) {
+            if (counter) {
+                counter->elements.fetch_add(elements, std::memory_order_relaxed);
+                counter->bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+        }
+
+        ~Scope() {
+            if (counter) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                counter->nanoseconds.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+            }
+        }
+    };
+
+#ifdef MYCONTAINER_STATS
+    namespace {
+        // Turns collection on before main; internal to each translation unit that defines
+        // the macro, so it is no ODR concern
+        const bool collectingFromStart = (setEnabled(true), true);
+    }
+#endif
+
+} // namespace stats
+} // namespace genericContainer
+
+#endif // EX4_CONTAINERSTATS_HPP
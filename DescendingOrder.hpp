@@ -4,140 +4,190 @@
 #define EX4_DESCENDINGORDER_HPP
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <algorithm>
 #include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
 
 namespace genericContainer {
 
     // Template class for iterating through a container in descending order
-    template<typename T>
+    template<typename T, typename Checks = DefaultIteratorChecks>
     class DescendingOrder {
     private:
-        std::vector<T> sortedData;  // Stores the elements sorted in descending order
+        std::shared_ptr<const SortedIndex<T>> sortedData;  // Elements sorted in ascending order, walked from the back
 
     public:
-        // Nested iterator class
+        // Nested iterator class – a standard random access iterator
         class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
         private:
-            const std::vector<T>* data;  // Pointer to sorted vector
-            size_t index;                // Current index
+            const SortedIndex<T>* data;  // Pointer to ascending sort index
+            size_t index;                // Index from the back (0 is the largest element)
+            GenerationGuard guard;       // Validity of a permutation index
+
+            // Underlying position of the element visited at step p
+            size_t position(size_t p) const {
+                return data->size() - 1 - p;
+            }
 
         public:
+            // Default constructor – singular iterator, only assignable
+            Iterator() : data(nullptr), index(0) {}
+
             // Constructor
-            Iterator(const std::vector<T>* data, size_t index)
-                    : data(data), index(index) {
-                if (!data) {
-                    throw std::invalid_argument("Null data pointer passed to Iterator.");
-                }
+            Iterator(const SortedIndex<T>* data, size_t index)
+                    : data(data), index(index),
+                      guard(data ? data->generationGuard() : GenerationGuard()) {
+                failIf<Checks, std::invalid_argument>(!data, "Null data pointer passed to Iterator.");
+            }
+
+            // Dereference operator
+            reference operator*() const {
+                guard.check<Checks>();
+                failIf<Checks, std::out_of_range>(index >= data->size(),
+                                                  "Attempted to dereference out-of-bounds iterator.");
+                return (*data)[position(index)];
             }
 
-            // Dereference operator – returns current element
-            const T& operator*() const {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Attempted to dereference out-of-bounds iterator.");
-                }
-                return data->at(index);
+            // Member access (it->member)
+            pointer operator->() const {
+                return &**this;
             }
 
-            // Prefix increment – move forward (toward smaller elements)
+            // Prefix increment (++it)
             Iterator& operator++() {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Cannot increment past the end.");
-                }
+                failIf<Checks, std::out_of_range>(index >= data->size(), "Cannot increment past the end.");
                 ++index;
                 return *this;
             }
 
-            // Postfix increment
+            // Postfix increment (it++)
             Iterator operator++(int) {
                 Iterator temp = *this;
                 ++(*this);
                 return temp;
             }
 
-            // Prefix decrement – move backward
+            // Prefix decrement (--it)
             Iterator& operator--() {
-                if (index == 0) {
-                    throw std::out_of_range("Cannot decrement below 0.");
-                }
+                failIf<Checks, std::out_of_range>(index == 0, "Cannot decrement below 0.");
                 --index;
                 return *this;
             }
 
-            // Postfix decrement
+            // Postfix decrement (it--)
             Iterator operator--(int) {
                 Iterator temp = *this;
                 --(*this);
                 return temp;
             }
 
-            // Random access via index offset
-            const T& operator[](size_t offset) const {
-                if (index + offset >= data->size()) {
-                    throw std::out_of_range("Random access out of range.");
-                }
-                return data->at(index + offset);
+            // Random access (it[n]) – O(1), n may be negative
+            reference operator[](difference_type offset) const {
+                guard.check<Checks>();
+                difference_type target = static_cast<difference_type>(index) + offset;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) >= data->size(),
+                                                  "Random access out of range.");
+                return (*data)[position(static_cast<size_t>(target))];
             }
 
-            // Iterator + offset
-            Iterator operator+(int n) const {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator + offset out of range.");
-                }
-                return Iterator(data, index + n);
+            // Add and assign (it += n) – O(1), n may be negative
+            Iterator& operator+=(difference_type n) {
+                difference_type target = static_cast<difference_type>(index) + n;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) > data->size(),
+                                                  "Iterator += out of range.");
+                index = static_cast<size_t>(target);
+                return *this;
             }
 
-            // Iterator - offset
-            Iterator operator-(int n) const {
-                if (n > index) {
-                    throw std::out_of_range("Iterator - offset out of range.");
-                }
-                return Iterator(data, index - n);
+            // Subtract and assign (it -= n)
+            Iterator& operator-=(difference_type n) {
+                return *this += -n;
             }
 
-            // Iterator += offset
-            Iterator& operator+=(int n) {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator += out of range.");
-                }
-                index += n;
-                return *this;
+            // Jump forward (it + n)
+            Iterator operator+(difference_type n) const {
+                Iterator result = *this;
+                result += n;
+                return result;
             }
 
-            // Iterator -= offset
-            Iterator& operator-=(int n) {
-                if (n > index) {
-                    throw std::out_of_range("Iterator -= out of range.");
-                }
-                index -= n;
-                return *this;
+            // Jump forward (n + it)
+            friend Iterator operator+(difference_type n, const Iterator& it) {
+                return it + n;
             }
 
-            // Inequality comparison – used in loops
-            bool operator!=(const Iterator& other) const {
-                return index != other.index || data != other.data;
+            // Jump backward (it - n)
+            Iterator operator-(difference_type n) const {
+                Iterator result = *this;
+                result -= n;
+                return result;
             }
 
-            // Equality comparison (optional)
+            // Distance between two iterators of the same view (it - other) – O(1)
+            difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+            }
+
+            // Equality comparison
             bool operator==(const Iterator& other) const {
                 return index == other.index && data == other.data;
             }
+
+            // Inequality comparison
+            bool operator!=(const Iterator& other) const {
+                return !(*this == other);
+            }
+
+            // Ordering – iterators of the same view compare by step
+            bool operator<(const Iterator& other) const {
+                return index < other.index;
+            }
+
+            bool operator>(const Iterator& other) const {
+                return other < *this;
+            }
+
+            bool operator<=(const Iterator& other) const {
+                return !(other < *this);
+            }
+
+            bool operator>=(const Iterator& other) const {
+                return !(*this < other);
+            }
         };
 
-        // Constructor: copy and sort descending
+        // Constructor: copy and sort (ascending, iterated in reverse)
         DescendingOrder(const std::vector<T>& original) {
-            sortedData = original;
-            std::sort(sortedData.begin(), sortedData.end(), std::greater<T>());
+            sortedData = std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(original));
+        }
+
+        // Constructor: shares an existing sort index (no copy, no sort)
+        explicit DescendingOrder(std::shared_ptr<const SortedIndex<T>> sorted)
+                : sortedData(std::move(sorted)) {
+            if (!sortedData) {
+                throw std::invalid_argument("Null sorted data passed to DescendingOrder.");
+            }
         }
 
         // Begin iterator – points to the first (largest) element
         Iterator begin() const {
-            return Iterator(&sortedData, 0);
+            return Iterator(sortedData.get(), 0);
         }
 
         // End iterator – points one past the last (smallest) element
         Iterator end() const {
-            return Iterator(&sortedData, sortedData.size());
+            return Iterator(sortedData.get(), sortedData->size());
         }
     };
 
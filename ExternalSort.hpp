@@ -0,0 +1,247 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_EXTERNALSORT_HPP
+#define EX4_EXTERNALSORT_HPP
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <type_traits>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "Sorting.hpp"
+
+namespace genericContainer {
+
+    namespace external {
+
+        // Smallest read buffer per run during the merge
+        constexpr size_t minRunBuffer = 4096;
+
+        // Temporary file that is unlinked as soon as it is created: it disappears when
+        // closed and unmapped, even if the process dies
+        class ScratchFile {
+        private:
+            int fd;
+            uint64_t length = 0;
+
+            [[noreturn]] static void fail(const std::string& what) {
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+
+        public:
+            // directory: where to spill ("" = $TMPDIR, else /tmp)
+            explicit ScratchFile(const std::string& directory) {
+                std::string dir = directory;
+                if (dir.empty()) {
+                    const char* tmp = std::getenv("TMPDIR");
+                    dir = tmp && *tmp ? tmp : "/tmp";
+                }
+                std::string path = dir + "/mycontainer-spill-XXXXXX";
+                fd = ::mkstemp(&path[0]);
+                if (fd < 0) {
+                    fail("Cannot create a spill file in " + dir);
+                }
+                ::unlink(path.c_str());
+            }
+
+            ScratchFile(const ScratchFile&) = delete;
+            ScratchFile& operator=(const ScratchFile&) = delete;
+
+            ~ScratchFile() {
+                ::close(fd);
+            }
+
+            uint64_t size() const {
+                return length;
+            }
+
+            // Appends bytes at the end of the file
+            void append(const void* data, size_t bytes) {
+                const char* from = static_cast<const char*>(data);
+                while (bytes > 0) {
+                    ssize_t written = ::pwrite(fd, from, bytes, static_cast<off_t>(length));
+                    if (written < 0) {
+                        if (errno == EINTR) continue;
+                        fail("Cannot write a spill file");
+                    }
+                    from += written;
+                    bytes -= static_cast<size_t>(written);
+                    length += static_cast<uint64_t>(written);
+                }
+            }
+
+            // Reads exactly bytes from offset
+            void read(void* data, size_t bytes, uint64_t offset) const {
+                char* to = static_cast<char*>(data);
+                while (bytes > 0) {
+                    ssize_t got = ::pread(fd, to, bytes, static_cast<off_t>(offset));
+                    if (got < 0) {
+                        if (errno == EINTR) continue;
+                        fail("Cannot read a spill file");
+                    }
+                    if (got == 0) {
+                        errno = EIO;
+                        fail("Spill file ended early");
+                    }
+                    to += got;
+                    bytes -= static_cast<size_t>(got);
+                    offset += static_cast<uint64_t>(got);
+                }
+            }
+
+            // Maps the whole file read-only; the mapping outlives the file descriptor.
+            // Views read it in any order (it[n], binary search), so no readahead hint.
+            std::shared_ptr<const void> map() const {
+                if (length == 0) {
+                    return nullptr;
+                }
+                void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+                if (address == MAP_FAILED) {
+                    fail("Cannot map a spill file");
+                }
+                size_t bytes = static_cast<size_t>(length);
+                return std::shared_ptr<const void>(address, [bytes](const void* p) {
+                    ::munmap(const_cast<void*>(p), bytes);
+                });
+            }
+        };
+
+        // Sequential reader of one sorted run, buffered
+        template<typename T>
+        class RunReader {
+        private:
+            const ScratchFile* file;
+            uint64_t next;           // File offset of the first element not yet buffered
+            uint64_t end;            // File offset past the run
+            std::vector<T> buffer;
+            size_t position = 0;
+
+            void refill() {
+                size_t count = static_cast<size_t>(std::min<uint64_t>(buffer.capacity(), (end - next) / sizeof(T)));
+                buffer.resize(count);
+                file->read(buffer.data(), count * sizeof(T), next);
+                next += count * sizeof(T);
+                position = 0;
+            }
+
+        public:
+            RunReader(const ScratchFile& file, uint64_t begin, uint64_t end, size_t bufferElements)
+                    : file(&file), next(begin), end(end) {
+                buffer.reserve(bufferElements);
+                refill();
+            }
+
+            bool done() const {
+                return position == buffer.size();
+            }
+
+            const T& current() const {
+                return buffer[position];
+            }
+
+            void advance() {
+                if (++position == buffer.size() && next < end) {
+                    refill();
+                }
+            }
+        };
+
+        // Merges runs [first, last) of from (delimited by bounds) and appends the result to to,
+        // reading each run through a buffer of bufferElements and writing through another
+        template<typename T>
+        void mergeRuns(const ScratchFile& from, const std::vector<uint64_t>& bounds, size_t first, size_t last,
+                       ScratchFile& to, size_t bufferElements) {
+            std::vector<RunReader<T>> readers;
+            readers.reserve(last - first);
+            for (size_t r = first; r < last; ++r) {
+                readers.emplace_back(from, bounds[r], bounds[r + 1], bufferElements);
+            }
+
+            // Min-heap of reader numbers keyed by each run's current element
+            auto greater = [&readers](size_t a, size_t b) { return readers[b].current() < readers[a].current(); };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+            for (size_t r = 0; r < readers.size(); ++r) {
+                if (!readers[r].done()) heap.push(r);
+            }
+            std::vector<T> out;
+            out.reserve(bufferElements);
+            while (!heap.empty()) {
+                size_t r = heap.top();
+                heap.pop();
+                out.push_back(readers[r].current());
+                if (out.size() == bufferElements) {
+                    to.append(out.data(), out.size() * sizeof(T));
+                    out.clear();
+                }
+                readers[r].advance();
+                if (!readers[r].done()) heap.push(r);
+            }
+            to.append(out.data(), out.size() * sizeof(T));
+        }
+
+        // Sorts the count elements forEach(f) visits using about memoryLimit bytes of RAM:
+        // sorted runs are spilled to a scratch file and k-way merged into a second one,
+        // which is returned mapped read-only (the elements in ascending order). A merge
+        // reads at most memoryLimit / minRunBuffer - 1 runs at once (at least 2); more runs
+        // than that are merged in several passes, each into a new file.
+        template<typename T, typename ForEach>
+        std::shared_ptr<const void> sortToFile(size_t count, ForEach forEach, const SortOptions& options) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types are spilled");
+
+            // A run and the radix sort's scratch copy of it must both fit
+            size_t runElements = std::max<size_t>(options.memoryLimit / (2 * sizeof(T)), 1);
+            auto runs = std::make_unique<ScratchFile>(options.spillDirectory);
+            std::vector<uint64_t> bounds{0};
+            {
+                std::vector<T> run;
+                run.reserve(std::min(runElements, count));
+                auto spill = [&] {
+                    sortKeys(run, std::less<T>(), options);
+                    runs->append(run.data(), run.size() * sizeof(T));
+                    bounds.push_back(runs->size());
+                    run.clear();
+                };
+                forEach([&](const T& item) {
+                    run.push_back(item);
+                    if (run.size() == runElements) {
+                        spill();
+                    }
+                });
+                if (!run.empty()) {
+                    spill();
+                }
+            }
+
+            // One buffer per merged run plus one for the output, each at least minRunBuffer
+            size_t fanIn = std::max<size_t>(options.memoryLimit / minRunBuffer, 3) - 1;
+            while (bounds.size() - 1 > 1) {
+                size_t runCount = bounds.size() - 1;
+                size_t width = std::min(runCount, fanIn);
+                size_t bufferBytes = std::max(options.memoryLimit / (width + 1), minRunBuffer);
+                size_t bufferElements = std::max<size_t>(bufferBytes / sizeof(T), 1);
+
+                auto merged = std::make_unique<ScratchFile>(options.spillDirectory);
+                std::vector<uint64_t> mergedBounds{0};
+                for (size_t first = 0; first < runCount; first += width) {
+                    mergeRuns<T>(*runs, bounds, first, std::min(first + width, runCount), *merged, bufferElements);
+                    mergedBounds.push_back(merged->size());
+                }
+                runs = std::move(merged);
+                bounds = std::move(mergedBounds);
+            }
+            return runs->map();
+        }
+
+    } // namespace external
+
+} // namespace genericContainer
+
+#endif // EX4_EXTERNALSORT_HPP
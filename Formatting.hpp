@@ -0,0 +1,213 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_FORMATTING_HPP
+#define EX4_FORMATTING_HPP
+
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <ostream>
+#include <string>
+#include <locale>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+
+namespace genericContainer {
+
+    namespace formatting {
+
+        // Element types written straight into the buffer: arithmetic types and std::string
+        template<typename T>
+        struct Buffered : std::integral_constant<bool, std::is_arithmetic<T>::value ||
+                                                       std::is_same<T, std::string>::value> {};
+
+        // True if os formats numbers exactly like std::to_chars: decimal, no padding,
+        // sign or show flags, classic locale
+        inline bool plainStream(const std::ostream& os) {
+            const std::ios_base::fmtflags relevant = std::ios_base::basefield | std::ios_base::floatfield |
+                                                     std::ios_base::adjustfield | std::ios_base::boolalpha |
+                                                     std::ios_base::showbase | std::ios_base::showpoint |
+                                                     std::ios_base::showpos | std::ios_base::uppercase;
+            return (os.flags() & relevant) == std::ios_base::dec && os.width() == 0 &&
+                   os.getloc() == std::locale::classic();
+        }
+
+        // Formats "[ a b c ]" into a heap buffer and hands it to write(const char*, size_t)
+        // in 64 KiB blocks. Numbers use std::to_chars (floating point with the stream's
+        // precision, as %g), characters and strings are copied as is.
+        template<typename Write>
+        class Formatter {
+        private:
+            static constexpr size_t capacity = size_t(1) << 16;
+            static constexpr size_t maxNumber = 128;  // Room kept before a number; longer ones retry
+
+            Write write;
+            int precision;
+            size_t used = 0;
+            std::unique_ptr<char[]> buffer;
+
+            void flush() {
+                if (used > 0) {
+                    write(buffer.get(), used);
+                    used = 0;
+                }
+            }
+
+            void append(const char* text, size_t length) {
+                if (length > capacity - used) {
+                    flush();
+                    if (length > capacity) {
+                        write(text, length);
+                        return;
+                    }
+                }
+                std::memcpy(buffer.get() + used, text, length);
+                used += length;
+            }
+
+            // Converts item with std::to_chars into the space left, flushing and retrying
+            // with the whole buffer if it does not fit (e.g. %g with a large precision);
+            // output longer than a block is built in a string of its own
+            template<typename T, typename... Format>
+            void number(const T& item, Format... format) {
+                for (int attempt = 0; attempt < 2; ++attempt) {
+                    std::to_chars_result result = std::to_chars(buffer.get() + used, buffer.get() + capacity,
+                                                                item, format...);
+                    if (result.ec == std::errc()) {
+                        used = static_cast<size_t>(result.ptr - buffer.get());
+                        return;
+                    }
+                    flush();
+                }
+                std::string text(2 * capacity, '\0');
+                while (true) {
+                    std::to_chars_result result = std::to_chars(&text[0], &text[0] + text.size(), item, format...);
+                    if (result.ec == std::errc()) {
+                        append(text.data(), static_cast<size_t>(result.ptr - text.data()));
+                        return;
+                    }
+                    text.resize(2 * text.size());
+                }
+            }
+
+        public:
+            Formatter(Write write, int precision)
+                    : write(write), precision(precision), buffer(new char[capacity]) {
+                append("[ ", 2);
+            }
+
+            Formatter(const Formatter&) = delete;
+            Formatter& operator=(const Formatter&) = delete;
+
+            // Appends item followed by a space
+            template<typename T>
+            void item(const T& item) {
+                static_assert(Buffered<T>::value, "Formatter writes arithmetic types and std::string");
+                if constexpr (std::is_same<T, std::string>::value) {
+                    append(item.data(), item.size());
+                    append(" ", 1);
+                } else {
+                    if (capacity - used < maxNumber) {
+                        flush();
+                    }
+                    if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                                  std::is_same<T, unsigned char>::value) {
+                        buffer[used++] = static_cast<char>(item);
+                    } else if constexpr (std::is_same<T, bool>::value) {
+                        buffer[used++] = item ? '1' : '0';
+                    } else if constexpr (std::is_floating_point<T>::value) {
+                        number(item, std::chars_format::general, precision);
+                    } else {
+                        number(item);
+                    }
+                    if (used == capacity) {
+                        flush();
+                    }
+                    buffer[used++] = ' ';
+                }
+            }
+
+            // Writes the closing bracket and everything still buffered
+            void finish() {
+                append("]", 1);
+                flush();
+            }
+        };
+
+        // Block writer for an ostream
+        struct StreamWrite {
+            std::ostream* os;
+
+            void operator()(const char* data, size_t length) const {
+                os->write(data, static_cast<std::streamsize>(length));
+            }
+        };
+
+        // Block writer for a POSIX file descriptor; retries partial and interrupted writes
+        struct FdWrite {
+            int fd;
+
+            void operator()(const char* data, size_t length) const {
+                while (length > 0) {
+                    ssize_t written = ::write(fd, data, length);
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw std::system_error(errno, std::generic_category(), "write to file descriptor failed");
+                    }
+                    data += written;
+                    length -= static_cast<size_t>(written);
+                }
+            }
+        };
+
+        // Writes "[ a b c ]" for the elements forEach(f) visits. Buffered types take the
+        // fast path when the stream has default formatting; anything else uses os << item.
+        template<typename T, typename ForEach>
+        void writeItems(std::ostream& os, ForEach forEach) {
+            if constexpr (Buffered<T>::value) {
+                if (plainStream(os)) {
+                    Formatter<StreamWrite> formatter(StreamWrite{&os}, static_cast<int>(os.precision()));
+                    forEach([&formatter](const T& item) { formatter.item(item); });
+                    formatter.finish();
+                    return;
+                }
+            }
+            os << "[ ";
+            forEach([&os](const T& item) {
+                os << item << " ";
+            });
+            os << "]";
+        }
+
+    } // namespace formatting
+
+    // Writes any view (e.g. c.ascendingOrder(), c.orderView()) as "[ a b c ]"
+    template<typename View>
+    void writeFormatted(std::ostream& os, const View& view) {
+        using T = typename std::decay<decltype(*view.begin())>::type;
+        formatting::writeItems<T>(os, [&view](auto f) {
+            for (auto it = view.begin(); it != view.end(); ++it) {
+                f(*it);
+            }
+        });
+    }
+
+    // Writes any view of arithmetic or std::string elements to a file descriptor as
+    // "[ a b c ]", formatted as a default std::ostream would (floating point with
+    // precision digits). Throws std::system_error if a write fails.
+    template<typename View>
+    void writeFormatted(int fd, const View& view, int precision = 6) {
+        formatting::Formatter<formatting::FdWrite> formatter(formatting::FdWrite{fd}, precision);
+        for (auto it = view.begin(); it != view.end(); ++it) {
+            formatter.item(*it);
+        }
+        formatter.finish();
+    }
+
+} // namespace genericContainer
+
+#endif // EX4_FORMATTING_HPP
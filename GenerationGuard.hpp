@@ -0,0 +1,42 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_GENERATIONGUARD_HPP
+#define EX4_GENERATIONGUARD_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include "IteratorChecks.hpp"
+
+namespace genericContainer {
+
+    // Detects use of a borrowing view after its container was modified.
+    // Owning views have no live counter and are always valid.
+    class GenerationGuard {
+    private:
+        const size_t* live;  // Container's modification counter (nullptr for owning views)
+        size_t expected;     // Counter value when the view was created
+
+    public:
+        // Constructor – owning view, never invalidated
+        GenerationGuard() : live(nullptr), expected(0) {}
+
+        // Constructor – remembers the current value of the container's counter
+        explicit GenerationGuard(const size_t* live)
+                : live(live), expected(live ? *live : 0) {}
+
+        // True while the container has not been modified
+        bool valid() const {
+            return !live || *live == expected;
+        }
+
+        // Throws if the container was modified since the view was created
+        // (only asserts under UncheckedIterators)
+        template<typename Checks = CheckedIterators>
+        void check() const {
+            failIf<Checks, std::logic_error>(!valid(), "View used after its container was modified.");
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_GENERATIONGUARD_HPP
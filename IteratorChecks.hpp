@@ -0,0 +1,47 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_ITERATORCHECKS_HPP
+#define EX4_ITERATORCHECKS_HPP
+
+#include <cassert>
+
+namespace genericContainer {
+
+    // Iterator check policies, passed as the Checks template parameter of every order view.
+    // Checked iterators throw on misuse (bounds, modified container).
+    struct CheckedIterators {
+        static constexpr bool enabled = true;
+    };
+
+    // Unchecked iterators only assert – nothing at all is left when NDEBUG is defined,
+    // so hot loops have no branches or exception paths and can be vectorized.
+    struct UncheckedIterators {
+        static constexpr bool enabled = false;
+    };
+
+    // Default policy for MyContainer's views; define MYCONTAINER_UNCHECKED_ITERATORS
+    // in release builds to switch every view to unchecked iterators.
+#ifdef MYCONTAINER_UNCHECKED_ITERATORS
+    using DefaultIteratorChecks = UncheckedIterators;
+#else
+    using DefaultIteratorChecks = CheckedIterators;
+#endif
+
+    // Reports a broken iterator precondition: throws Exception(message) when checks
+    // are enabled, otherwise asserts (debug builds only)
+    template<typename Checks, typename Exception>
+    inline void failIf(bool failed, const char* message) {
+        if constexpr (Checks::enabled) {
+            if (failed) {
+                throw Exception(message);
+            }
+        } else {
+            assert(!failed && message);
+            (void)failed;
+            (void)message;
+        }
+    }
+
+} // namespace genericContainer
+
+#endif // EX4_ITERATORCHECKS_HPP
@@ -0,0 +1,123 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_MAPPEDCONTAINER_HPP
+#define EX4_MAPPEDCONTAINER_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include "BinaryFormat.hpp"
+#include "MappedSpan.hpp"
+#include "SortedIndex.hpp"
+#include "AscendingOrder.hpp"
+#include "DescendingOrder.hpp"
+#include "SideCrossOrder.hpp"
+#include "ReverseOrder.hpp"
+#include "Order.hpp"
+#include "MiddleOutOrder.hpp"
+
+namespace genericContainer {
+
+    // Read-only container over a file written by MyContainer::save. The file is mapped,
+    // not read: opening costs O(1) and pages are loaded as views touch them. All six
+    // views read the mapping in place and keep it alive, so they may outlive this object.
+    // The sorted views are permutations over the mapping (the file never changes and the
+    // index keeps it alive); a stored permutation serves them without a sort.
+    template<typename T>
+    class MappedContainer {
+    private:
+        static_assert(std::is_trivially_copyable<T>::value, "Mapped files hold trivially copyable types only");
+
+        std::shared_ptr<const binary::MappedFile> file;
+        MappedSpan<T> items;
+        // Sort index built on the first sorted view; const readers fill it under lock.
+        // Copies start empty and build their own.
+        struct IndexCache {
+            std::shared_ptr<const SortedIndex<T>> index;
+            std::mutex lock;
+
+            IndexCache() = default;
+            IndexCache(const IndexCache&) {}
+            IndexCache& operator=(const IndexCache&) {
+                index.reset();
+                return *this;
+            }
+        };
+
+        mutable IndexCache cache;
+        SortOptions sortOptions;
+
+        // Returns the shared sort index: from the file's permutation, or sorted once
+        std::shared_ptr<const SortedIndex<T>> sortedData() const {
+            std::lock_guard<std::mutex> guard(cache.lock);
+            if (!cache.index) {
+                SortOptions options = sortOptions;
+                options.permute = true;
+                if (file->hasPermutation()) {
+                    cache.index = std::make_shared<const SortedIndex<T>>(
+                            file->permutationIndex(items.begin(), nullptr, options, file));
+                } else {
+                    cache.index = std::make_shared<const SortedIndex<T>>(
+                            SortedIndex<T>::byPermutation(items.begin(), items.size(), nullptr, options, file));
+                }
+            }
+            return cache.index;
+        }
+
+    public:
+        // Maps path; throws std::system_error if it cannot be opened and
+        // std::runtime_error if it is not a container file of T
+        explicit MappedContainer(const std::string& path)
+                : file(std::make_shared<const binary::MappedFile>(binary::MappedFile::open<T>(path))),
+                  items(file, file->elements<T>(), file->size()) {}
+
+        size_t size() const {
+            return items.size();
+        }
+
+        // True if the file carries a precomputed ascending permutation
+        bool hasPermutation() const {
+            return file->hasPermutation();
+        }
+
+        // Lazy or parallel sorting for files without a permutation (see MyContainer)
+        void setLazySort(bool enabled) {
+            sortOptions.lazy = enabled;
+            cache.index.reset();
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        AscendingOrder<T, Checks> ascendingOrder() const {
+            return AscendingOrder<T, Checks>(sortedData());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        DescendingOrder<T, Checks> descendingOrder() const {
+            return DescendingOrder<T, Checks>(sortedData());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        SideCrossOrder<T, Checks> sideCrossOrder() const {
+            return SideCrossOrder<T, Checks>(sortedData());
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        ReverseOrder<T, Checks, MappedSpan<T>> reverseOrder() const {
+            return ReverseOrder<T, Checks, MappedSpan<T>>(items);
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        Order<T, Checks, MappedSpan<T>> order() const {
+            return Order<T, Checks, MappedSpan<T>>(items);
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        MiddleOutOrder<T, Checks, MappedSpan<T>> middleOutOrder() const {
+            return MiddleOutOrder<T, Checks, MappedSpan<T>>(items);
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_MAPPEDCONTAINER_HPP
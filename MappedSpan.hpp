@@ -0,0 +1,50 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_MAPPEDSPAN_HPP
+#define EX4_MAPPEDSPAN_HPP
+
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace genericContainer {
+
+    // Read-only run of elements inside a mapped file, with shared ownership of the
+    // mapping – the element sequence of MappedContainer's views. Copying is O(1).
+    template<typename T>
+    class MappedSpan {
+    private:
+        std::shared_ptr<const void> owner;  // Keeps the mapping alive
+        const T* items;
+        size_t count;
+
+    public:
+        MappedSpan() : items(nullptr), count(0) {}
+
+        MappedSpan(std::shared_ptr<const void> owner, const T* items, size_t count)
+                : owner(std::move(owner)), items(items), count(count) {}
+
+        size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        const T& operator[](size_t i) const {
+            return items[i];
+        }
+
+        const T* begin() const {
+            return items;
+        }
+
+        const T* end() const {
+            return items + count;
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_MAPPEDSPAN_HPP
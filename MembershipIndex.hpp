@@ -0,0 +1,164 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_MEMBERSHIPINDEX_HPP
+#define EX4_MEMBERSHIPINDEX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace genericContainer {
+
+    // Optional value index kept by MyContainer on add/remove (see setMembershipIndex)
+    enum class Membership {
+        None,    // No index: contains/count scan, remove of a missing value scans then throws
+        Exact,   // Hash map value -> occurrences: O(1) contains/count, about 40+ bytes per distinct value
+        Filter   // Counting Bloom filter, 10 bytes per element: O(1) "definitely absent", else a scan
+    };
+
+    // True if std::hash<T> is usable
+    template<typename T, typename = void>
+    struct Hashable : std::false_type {};
+
+    template<typename T>
+    struct Hashable<T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))>> : std::true_type {};
+
+    // Answers "how many of value?" without touching the container.
+    // Exact mode counts each value; Filter mode may report a missing value as present
+    // (about 1% of the time when sized right) but never the reverse.
+    template<typename T, bool = Hashable<T>::value>
+    class MembershipIndex {
+    private:
+        static constexpr size_t countersPerElement = 10;
+        static constexpr size_t probes = 4;
+        static constexpr uint8_t saturated = 255;  // A counter that overflowed stays set for good
+
+        Membership mode = Membership::None;
+        std::unordered_map<T, size_t> counts;  // Exact mode
+        std::vector<uint8_t> counters;         // Filter mode, a power-of-two count
+        size_t capacity = 0;                   // Elements the filter was sized for
+
+        // Mixes the std::hash value (often the identity for integers) into two probe hashes
+        static uint64_t mix(uint64_t h) {
+            h += 0x9e3779b97f4a7c15ULL;
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+            return h ^ (h >> 31);
+        }
+
+        // Calls f(counter) for each of the value's probe positions
+        template<typename Counters, typename Function>
+        static void forProbes(Counters& counters, const T& value, Function f) {
+            uint64_t h1 = mix(std::hash<T>()(value));
+            uint64_t h2 = mix(h1) | 1;
+            size_t mask = counters.size() - 1;
+            for (size_t i = 0; i < probes; ++i) {
+                f(counters[(h1 + i * h2) & mask]);
+            }
+        }
+
+    public:
+        Membership kind() const {
+            return mode;
+        }
+
+        bool enabled() const {
+            return mode != Membership::None;
+        }
+
+        // Switches mode and drops every entry; the caller then inserts each element.
+        // expected sizes the filter (ignored in the other modes).
+        void reset(Membership newMode, size_t expected) {
+            mode = newMode;
+            counts = std::unordered_map<T, size_t>();
+            counters.clear();
+            counters.shrink_to_fit();
+            capacity = 0;
+            if (mode == Membership::Filter) {
+                capacity = std::max<size_t>(expected, 64);
+                size_t size = 1;
+                while (size < capacity * countersPerElement) {
+                    size <<= 1;
+                }
+                counters.assign(size, 0);
+            }
+        }
+
+        void insert(const T& value) {
+            if (mode == Membership::Exact) {
+                ++counts[value];
+            } else if (mode == Membership::Filter) {
+                forProbes(counters, value, [](uint8_t& c) { if (c != saturated) ++c; });
+            }
+        }
+
+        // Forgets times occurrences of value, all of which were inserted
+        void erase(const T& value, size_t times = 1) {
+            if (mode == Membership::Exact) {
+                auto it = counts.find(value);
+                if (it != counts.end() && (it->second -= std::min(times, it->second)) == 0) {
+                    counts.erase(it);
+                }
+            } else if (mode == Membership::Filter) {
+                forProbes(counters, value, [times](uint8_t& c) {
+                    if (c != saturated) c = static_cast<uint8_t>(c - std::min<size_t>(times, c));
+                });
+            }
+        }
+
+        // False only if value is certainly absent
+        bool mayContain(const T& value) const {
+            if (mode == Membership::Exact) {
+                return counts.count(value) != 0;
+            }
+            if (mode == Membership::Filter) {
+                bool present = true;
+                forProbes(counters, value, [&present](uint8_t c) {
+                    present = present && c != 0;
+                });
+                return present;
+            }
+            return true;
+        }
+
+        // Exact mode only: occurrences of value
+        size_t count(const T& value) const {
+            auto it = counts.find(value);
+            return it == counts.end() ? 0 : it->second;
+        }
+
+        // True once the filter holds twice the elements it was sized for – its false
+        // positive rate has degraded and it should be rebuilt
+        bool needsRebuild(size_t elements) const {
+            return mode == Membership::Filter && elements > 2 * capacity;
+        }
+    };
+
+    // Types without std::hash: the index is always off
+    template<typename T>
+    class MembershipIndex<T, false> {
+    public:
+        Membership kind() const { return Membership::None; }
+        bool enabled() const { return false; }
+
+        void reset(Membership newMode, size_t) {
+            if (newMode != Membership::None) {
+                throw std::logic_error("A membership index needs std::hash for the element type.");
+            }
+        }
+
+        void insert(const T&) {}
+        void erase(const T&, size_t = 1) {}
+        bool mayContain(const T&) const { return true; }
+        size_t count(const T&) const { return 0; }
+        bool needsRebuild(size_t) const { return false; }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_MEMBERSHIPINDEX_HPP
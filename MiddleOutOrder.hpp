@@ -4,75 +4,88 @@
 #define EX4_MIDDLEOUTORDER_HPP
 
 #include <vector>
+#include <utility>
+#include <cstddef>
+#include <iterator>
 #include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "GenerationGuard.hpp"
 
 namespace genericContainer {
 
     // Template class for iterating from the middle outwards in zigzag
-    template<typename T>
+    // Source is the element sequence: std::vector<T>, or an O(1)-copy ChunkedSnapshot<T>
+    template<typename T, typename Checks = DefaultIteratorChecks, typename Source = std::vector<T>>
     class MiddleOutOrder {
     private:
-        std::vector<T> dataCopy;  // Copy of the original container
+        Source dataCopy;         // Copy of the original container (owning views)
+        const Source* borrowed;  // Container data iterated in place (borrowing views)
+        GenerationGuard guard;   // Detects a borrowed container being modified
+
+        // Data the iterators walk over
+        const Source* items() const {
+            return borrowed ? borrowed : &dataCopy;
+        }
 
     public:
-        // Iterator nested class
+        // Nested iterator class – a standard random access iterator
         class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
         private:
-            const std::vector<T>* data;  // Pointer to the data
-            size_t total;                // Total elements in the data
+            const Source* data;  // Pointer to the data
             size_t count;                // Elements visited so far
-            size_t middle;              // Middle index
-            int left;                   // Left side iterator
-            size_t right;               // Right side iterator
-            bool leftTurn;              // Indicates which side to visit next
+            GenerationGuard guard;       // Validity of borrowed data
+
+            // Underlying position of the element visited at step p
+            size_t position(size_t p) const {
+                // Step 0 is the middle, then odd steps go left and even steps go right
+                size_t middle = data->size() / 2;
+                if (p % 2 == 1) return middle - (p + 1) / 2;
+                return middle + p / 2;
+            }
 
         public:
+            // Default constructor – singular iterator, only assignable
+            Iterator() : data(nullptr), count(0) {}
+
             // Constructor
-            Iterator(const std::vector<T>* data, bool atEnd = false)
+            Iterator(const Source* data, bool atEnd = false, GenerationGuard guard = GenerationGuard())
                     : data(data),
-                      total(data ? data->size() : 0),
                       count(0),
-                      middle(data ? data->size() / 2 : 0),
-                      left(static_cast<int>(middle) - 1),
-                      right(middle + 1),
-                      leftTurn(true) {
-                if (!data || data->empty()) {
-                    throw std::invalid_argument("MiddleOutOrder cannot be used on an empty container.");
-                }
+                      guard(guard) {
+                // A borrowed container emptied since is a stale view, not an empty one
+                guard.check<Checks>();
+                failIf<Checks, std::invalid_argument>(!data || data->empty(),
+                                                      "MiddleOutOrder cannot be used on an empty container.");
                 if (atEnd) {
-                    count = total;  // Mark as finished
+                    count = data->size();  // Mark as finished
                 }
             }
 
-            // Dereference – get current element
-            const T& operator*() const {
-                if (count >= total) {
-                    throw std::out_of_range("Iterator out of bounds in MiddleOutOrder.");
-                }
-                if (count == 0) {
-                    return data->at(middle);  // First visit is middle
-                }
-                if (leftTurn && left >= 0) {
-                    return data->at(left);
-                }
-                if (!leftTurn && right < data->size()) {
-                    return data->at(right);
-                }
-                throw std::out_of_range("Invalid access in MiddleOutOrder iterator.");
+            // Dereference operator
+            reference operator*() const {
+                guard.check<Checks>();
+                failIf<Checks, std::out_of_range>(count >= data->size(),
+                                                  "Iterator out of bounds in MiddleOutOrder.");
+                return (*data)[position(count)];
+            }
+
+            // Member access (it->member)
+            pointer operator->() const {
+                return &**this;
             }
 
             // Prefix increment (++it)
             Iterator& operator++() {
+                failIf<Checks, std::out_of_range>(count >= data->size(),
+                                                  "Cannot increment beyond end in MiddleOutOrder.");
                 ++count;
-                if (count == 1) return *this;  // Skip toggle on first middle step
-
-                if (leftTurn && left >= 0) {
-                    --left;
-                } else if (!leftTurn && right < data->size()) {
-                    ++right;
-                }
-
-                leftTurn = !leftTurn;
                 return *this;
             }
 
@@ -83,33 +96,122 @@ namespace genericContainer {
                 return temp;
             }
 
-            // Comparison for inequality
-            bool operator!=(const Iterator& other) const {
-                return count != other.count || data != other.data;
+            // Prefix decrement (--it)
+            Iterator& operator--() {
+                failIf<Checks, std::out_of_range>(count == 0,
+                                                  "Cannot decrement before beginning in MiddleOutOrder.");
+                --count;
+                return *this;
+            }
+
+            // Postfix decrement (it--)
+            Iterator operator--(int) {
+                Iterator temp = *this;
+                --(*this);
+                return temp;
+            }
+
+            // Random access (it[n]) – O(1), n may be negative
+            reference operator[](difference_type offset) const {
+                guard.check<Checks>();
+                difference_type target = static_cast<difference_type>(count) + offset;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) >= data->size(),
+                                                  "Random access out of bounds in MiddleOutOrder.");
+                return (*data)[position(static_cast<size_t>(target))];
+            }
+
+            // Add and assign (it += n) – O(1), n may be negative
+            Iterator& operator+=(difference_type n) {
+                difference_type target = static_cast<difference_type>(count) + n;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) > data->size(),
+                                                  "Iterator += out of range.");
+                count = static_cast<size_t>(target);
+                return *this;
+            }
+
+            // Subtract and assign (it -= n)
+            Iterator& operator-=(difference_type n) {
+                return *this += -n;
+            }
+
+            // Jump forward (it + n)
+            Iterator operator+(difference_type n) const {
+                Iterator result = *this;
+                result += n;
+                return result;
+            }
+
+            // Jump forward (n + it)
+            friend Iterator operator+(difference_type n, const Iterator& it) {
+                return it + n;
             }
 
-            // Comparison for equality
+            // Jump backward (it - n)
+            Iterator operator-(difference_type n) const {
+                Iterator result = *this;
+                result -= n;
+                return result;
+            }
+
+            // Distance between two iterators of the same view (it - other) – O(1)
+            difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(count) - static_cast<difference_type>(other.count);
+            }
+
+            // Equality comparison
             bool operator==(const Iterator& other) const {
                 return count == other.count && data == other.data;
             }
+
+            // Inequality comparison
+            bool operator!=(const Iterator& other) const {
+                return !(*this == other);
+            }
+
+            // Ordering – iterators of the same view compare by step
+            bool operator<(const Iterator& other) const {
+                return count < other.count;
+            }
+
+            bool operator>(const Iterator& other) const {
+                return other < *this;
+            }
+
+            bool operator<=(const Iterator& other) const {
+                return !(other < *this);
+            }
+
+            bool operator>=(const Iterator& other) const {
+                return !(*this < other);
+            }
         };
 
-        // Constructor – copy original data
-        MiddleOutOrder(const std::vector<T>& original)
-                : dataCopy(original) {
+        // Constructor – takes a copy of the original (O(1) for a ChunkedSnapshot; an
+        // rvalue, e.g. a vector allocated from an arena, is moved in with its allocator)
+        MiddleOutOrder(Source original)
+                : dataCopy(std::move(original)), borrowed(nullptr) {
             if (dataCopy.empty()) {
                 throw std::invalid_argument("Cannot create MiddleOutOrder on an empty container.");
             }
         }
 
+        // Constructor – borrows the original without copying;
+        // iterators throw std::logic_error once *generation changes
+        MiddleOutOrder(const Source& original, const size_t* generation)
+                : borrowed(&original), guard(generation) {
+            if (original.empty()) {
+                throw std::invalid_argument("Cannot create MiddleOutOrder on an empty container.");
+            }
+        }
+
         // Begin iterator
         Iterator begin() const {
-            return Iterator(&dataCopy);
+            return Iterator(items(), false, guard);
         }
 
         // End iterator
         Iterator end() const {
-            return Iterator(&dataCopy, true);
+            return Iterator(items(), true, guard);
         }
     };
 
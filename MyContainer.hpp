@@ -5,55 +5,334 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <utility>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
 #include <stdexcept>
+#include <memory_resource>
+#include <mutex>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
+#include "VectorStorage.hpp"
+#include "OrderedStorage.hpp"
+#include "ChunkedStorage.hpp"
+#include "SegmentedStorage.hpp"
+#include "TombstoneStorage.hpp"
+#include "ArenaBuffer.hpp"
+#include "ContainerStats.hpp"
+#include "MembershipIndex.hpp"
+#include "Formatting.hpp"
+#include "BinaryFormat.hpp"
 #include "AscendingOrder.hpp"
 #include "DescendingOrder.hpp"
 #include "SideCrossOrder.hpp"
 #include "ReverseOrder.hpp"
 #include "Order.hpp"
 #include "MiddleOutOrder.hpp"
+#include "Adaptors.hpp"
 
 namespace genericContainer {
 
-    template<typename T = int>
+    // Maps MyContainer's second parameter to a storage policy: policies are used as is,
+    // an allocator selects VectorStorage<T, Allocator>
+    template<typename T, typename Param, typename = void>
+    struct StorageFor {
+        using type = Param;
+    };
+
+    template<typename T, typename Param>
+    struct StorageFor<T, Param, std::void_t<decltype(std::declval<Param&>().allocate(size_t(1)))>> {
+        using type = VectorStorage<T, Param>;
+    };
+
+    // Storage is a policy class: VectorStorage<T> (default, contiguous),
+    // OrderedStorage<T> (always sorted, O(log n) add/remove) or
+    // ChunkedStorage<T> (copy-on-write chunks, O(1) snapshots and unsorted views),
+    // SegmentedStorage<T> (fixed chunks that never move, worst-case O(1) add) or
+    // TombstoneStorage<T> (remove marks slots dead, batched compaction).
+    // An allocator may be given instead, e.g. MyContainer<T, std::pmr::polymorphic_allocator<T>>.
+    template<typename T = int, typename Storage = VectorStorage<T>>
     class MyContainer {
     private:
-        std::vector<T> data;
+        using Policy = typename StorageFor<T, Storage>::type;
+
+        Policy data;
+        // Cached sort index. Copies and moves of the container start with an empty
+        // cache, since a permutation index points into the storage that built it.
+        // Const readers fill it under lock, so concurrent sorted views are safe.
+        struct SortCache {
+            std::shared_ptr<const SortedIndex<T>> index;
+            std::mutex lock;
+
+            SortCache() = default;
+            SortCache(const SortCache&) {}
+            SortCache(SortCache&& other) noexcept {
+                other.index.reset();
+            }
+            SortCache& operator=(const SortCache&) {
+                index.reset();
+                return *this;
+            }
+            SortCache& operator=(SortCache&& other) noexcept {
+                index.reset();
+                other.index.reset();
+                return *this;
+            }
+        };
+
+        // Modification counter checked by borrowing views. Assignment replaces the
+        // contents, so it bumps the counter instead of copying the source's (which could
+        // match a value a view captured); a move bumps the moved-from counter as well.
+        struct Generation {
+            size_t value = 0;
+
+            Generation() = default;
+            Generation(const Generation&) {}
+            Generation(Generation&& other) noexcept {
+                ++other.value;
+            }
+            Generation& operator=(const Generation&) {
+                ++value;
+                return *this;
+            }
+            Generation& operator=(Generation&& other) noexcept {
+                ++value;
+                ++other.value;
+                return *this;
+            }
+        };
+
+        mutable SortCache sortedCache;  // Lazily built sort index, reset on add/remove
+        Generation generation;          // Bumped on every add/remove/assignment, checked by borrowing views
+        SortOptions sortOptions;        // How sort indices are built (lazy, parallel)
+        MembershipIndex<T> membership;  // Optional value index (see setMembershipIndex)
+
+        // Returns the shared sort index, sorting only if the cache was invalidated
+        std::shared_ptr<const SortedIndex<T>> sortedData() const;
+
+        // Returns items, or throws std::invalid_argument if it is null with count > 0 –
+        // called in the mem-initializer, before the storage reads the array
+        static const T* checkedItems(const T* items, size_t count);
+
+        // Called after every modification of data
+        void invalidateViews();
+
+        // Adds item to the membership index and the storage (the index entry is undone
+        // if the storage throws)
+        void addIndexed(const T& item);
+
+        // Rebuilds the membership index after a removal threw partway
+        void resyncMembership();
+
+        // Removes every occurrence of the given values (used by removeAll)
+        size_t removeValues(std::vector<T> values);
+
+        // Copy of the elements allocated from resource (for the arena-backed views)
+        ArenaBuffer<T> itemsIn(std::pmr::memory_resource* resource) const;
+
+        // Elements an owning view copies (a ChunkedSnapshot is shared, not copied)
+        size_t viewCopySize() const {
+            return std::is_same<Items, ChunkedSnapshot<T>>::value ? 0 : data.size();
+        }
 
     public:
+        // Element sequence the unsorted views iterate: std::vector<T>, or ChunkedSnapshot<T>
+        using Items = typename Policy::Items;
+
+        MyContainer() = default;
+
+        // Empty container whose storage allocates from alloc (allocator-aware storage only),
+        // e.g. MyContainer<int, std::pmr::polymorphic_allocator<int>> c(&arena)
+        template<typename Alloc,
+                 typename = std::enable_if_t<std::is_constructible<Policy, const Alloc&>::value>>
+        explicit MyContainer(const Alloc& alloc)
+                : data(alloc) {}
+
+        // Bulk construction – one sized allocation instead of repeated add()
+        MyContainer(std::initializer_list<T> items);
+        MyContainer(const T* items, size_t count);
+
+        template<typename InputIt,
+                 typename = typename std::iterator_traits<InputIt>::iterator_category>
+        MyContainer(InputIt first, InputIt last);
+
         void add(const T& item);
         void remove(const T& item);
         size_t size() const;
 
-        template<typename U>
-        friend std::ostream& operator<<(std::ostream& os, const MyContainer<U>& container);
+        // Membership queries – O(1) with an exact membership index, else a scan (a filter
+        // answers most absent values without one)
+        bool contains(const T& item) const;
+        size_t count(const T& item) const;
+
+        // Bulk ingestion
+        void reserve(size_t capacity);
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last);
 
-        AscendingOrder<T> ascendingOrder() const {
-            return AscendingOrder<T>(data);
+        template<typename... Args>
+        void emplace(Args&&... args);
+
+        // Bulk removal – each runs a single in-place pass and returns the number removed
+        template<typename Predicate>
+        size_t removeIf(Predicate pred);
+
+        template<typename... Rest>
+        size_t removeAll(const T& first, const Rest&... rest);
+
+        template<typename Range,
+                 typename = std::enable_if_t<!std::is_convertible<const Range&, const T&>::value>>
+        size_t removeAll(const Range& values);
+
+        // Lazy sorting: sorted views settle only the positions they read, so walking the
+        // first k elements costs O(n + k log k) instead of a full O(n log n) sort
+        void setLazySort(bool enabled);
+
+        // Permutation sorting: sorted views read through a sorted array of positions into
+        // the container instead of sorted copies – no copies of T, but the views borrow the
+        // storage: they throw std::logic_error after add/remove and must not outlive the
+        // container. Off by default (see SortsByIndex for a per-type default).
+        void setPermutationSort(bool enabled);
+
+        // Parallel sorting: indices of at least threshold elements are sorted by a
+        // parallel merge sort split into the given number of tasks (0 = one per core)
+        void setParallelSort(size_t threshold, unsigned threads = 0);
+
+        // Limits the memory sorted views use to build their index (0 = no limit). Above it,
+        // trivially copyable elements are sorted in runs spilled to unlinked temporary files
+        // in directory ("" = $TMPDIR or /tmp), k-way merged, and read back through a mapping.
+        // Affects the next index built.
+        void setSortMemoryLimit(size_t bytes, const std::string& directory = "");
+
+        // Drops the cached sort index so the next sorted view builds a new one (e.g. to
+        // time the sort); views already made keep theirs
+        void dropSortIndex();
+
+        // Keeps an index of the values on every add/remove (T needs std::hash):
+        // Membership::Exact – value counts, so contains/count are O(1) and removing a missing
+        //   value throws without scanning;
+        // Membership::Filter – a counting Bloom filter (10 bytes per element) that rejects
+        //   about 99% of missing values in O(1), sized for expected elements and rebuilt as
+        //   the container grows;
+        // Membership::None – no index (default). Builds the index from the current elements.
+        void setMembershipIndex(Membership mode, size_t expected = 0);
+
+        // Immutable copy of the elements in insertion order – O(1) with ChunkedStorage
+        // (it shares the chunks), a full copy otherwise
+        Items snapshot() const;
+
+        // Binary files for trivially copyable T (see BinaryFormat.hpp). save writes the
+        // elements – plus their ascending permutation if withIndex, so the first sorted view
+        // after load (or from a MappedContainer) needs no sort. load replaces the contents.
+        void save(const std::string& path, bool withIndex = false) const;
+        void load(const std::string& path);
+
+        template<typename U, typename S>
+        friend std::ostream& operator<<(std::ostream& os, const MyContainer<U, S>& container);
+
+        // Views take an optional iterator check policy, e.g. ascendingOrder<UncheckedIterators>().
+        // The sorted views share one cached sort index – O(1) between mutations
+        template<typename Checks = DefaultIteratorChecks>
+        AscendingOrder<T, Checks> ascendingOrder() const {
+            stats::Scope scope(stats::AscendingView);
+            return AscendingOrder<T, Checks>(sortedData());
         }
 
-        DescendingOrder<T> descendingOrder() const {
-            return DescendingOrder<T>(data);
+        template<typename Checks = DefaultIteratorChecks>
+        DescendingOrder<T, Checks> descendingOrder() const {
+            stats::Scope scope(stats::DescendingView);
+            return DescendingOrder<T, Checks>(sortedData());
         }
 
-        SideCrossOrder<T> sideCrossOrder() const {
-            return SideCrossOrder<T>(data);
+        template<typename Checks = DefaultIteratorChecks>
+        SideCrossOrder<T, Checks> sideCrossOrder() const {
+            stats::Scope scope(stats::SideCrossView);
+            return SideCrossOrder<T, Checks>(sortedData());
         }
 
-        ReverseOrder<T> reverseOrder() const {
-            return ReverseOrder<T>(data);
+        template<typename Checks = DefaultIteratorChecks>
+        ReverseOrder<T, Checks, Items> reverseOrder() const {
+            stats::Scope scope(stats::ReverseView, viewCopySize(), viewCopySize() * sizeof(T));
+            return ReverseOrder<T, Checks, Items>(data.items());
         }
 
-        Order<T> order() const {
-            return Order<T>(data);
+        template<typename Checks = DefaultIteratorChecks>
+        Order<T, Checks, Items> order() const {
+            stats::Scope scope(stats::OrderView, viewCopySize(), viewCopySize() * sizeof(T));
+            return Order<T, Checks, Items>(data.items());
         }
 
+        template<typename Checks = DefaultIteratorChecks>
+        MiddleOutOrder<T, Checks, Items> middleOutOrder() const {
+            stats::Scope scope(stats::MiddleOutView, viewCopySize(), viewCopySize() * sizeof(T));
+            return MiddleOutOrder<T, Checks, Items>(data.items());
+        }
+
+        // Owning views whose copy is allocated from resource – e.g. a
+        // std::pmr::unsynchronized_pool_resource, or a monotonic arena released per request –
+        // so building and dropping them calls no malloc once the resource is warm.
+        // (Sorted views share the cached index and allocate nothing between changes.)
+        template<typename Checks = DefaultIteratorChecks>
+        ReverseOrder<T, Checks, ArenaBuffer<T>> reverseOrder(std::pmr::memory_resource* resource) const {
+            stats::Scope scope(stats::ReverseView, data.size(), data.size() * sizeof(T));
+            return ReverseOrder<T, Checks, ArenaBuffer<T>>(itemsIn(resource));
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        Order<T, Checks, ArenaBuffer<T>> order(std::pmr::memory_resource* resource) const {
+            stats::Scope scope(stats::OrderView, data.size(), data.size() * sizeof(T));
+            return Order<T, Checks, ArenaBuffer<T>>(itemsIn(resource));
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        MiddleOutOrder<T, Checks, ArenaBuffer<T>> middleOutOrder(std::pmr::memory_resource* resource) const {
+            stats::Scope scope(stats::MiddleOutView, data.size(), data.size() * sizeof(T));
+            return MiddleOutOrder<T, Checks, ArenaBuffer<T>>(itemsIn(resource));
+        }
+
+        // Borrowing views – iterate the container's data in place without copying.
+        // Using them after add/remove throws std::logic_error.
+        // Non-contiguous storage falls back to the owning views.
+        template<typename Checks = DefaultIteratorChecks>
+        Order<T, Checks, Items> orderView() const {
+            if constexpr (Policy::contiguous) {
+                stats::Scope scope(stats::OrderView);
+                return Order<T, Checks, Items>(data.items(), &generation.value);
+            } else {
+                return order<Checks>();
+            }
+        }
 
-        MiddleOutOrder<T> middleOutOrder() const {
-            return MiddleOutOrder<T>(data);
+        template<typename Checks = DefaultIteratorChecks>
+        ReverseOrder<T, Checks, Items> reverseOrderView() const {
+            if constexpr (Policy::contiguous) {
+                stats::Scope scope(stats::ReverseView);
+                return ReverseOrder<T, Checks, Items>(data.items(), &generation.value);
+            } else {
+                return reverseOrder<Checks>();
+            }
+        }
+
+        template<typename Checks = DefaultIteratorChecks>
+        MiddleOutOrder<T, Checks, Items> middleOutOrderView() const {
+            if constexpr (Policy::contiguous) {
+                stats::Scope scope(stats::MiddleOutView);
+                return MiddleOutOrder<T, Checks, Items>(data.items(), &generation.value);
+            } else {
+                return middleOutOrder<Checks>();
+            }
         }
     };
 
+    namespace pmr {
+        // MyContainer whose elements are allocated from a std::pmr::memory_resource
+        template<typename T>
+        using MyContainer = genericContainer::MyContainer<T, std::pmr::polymorphic_allocator<T>>;
+    }
+
 } // namespace genericContainer
 
 #include "MyContainer.tpp"
@@ -7,48 +7,378 @@
 
 namespace genericContainer {
 
+    // Constructs the container from a list of items
+    template<typename T, typename Storage>
+    MyContainer<T, Storage>::MyContainer(std::initializer_list<T> items)
+            : data(items.begin(), items.end()) {}
+
+    // Constructs the container from a contiguous array of count items.
+    // Braces evaluate left to right, so the pointer is checked before items + count.
+    template<typename T, typename Storage>
+    MyContainer<T, Storage>::MyContainer(const T* items, size_t count)
+            : data{checkedItems(items, count), items + count} {}
+
+    // Constructs the container from an iterator range
+    template<typename T, typename Storage>
+    template<typename InputIt, typename>
+    MyContainer<T, Storage>::MyContainer(InputIt first, InputIt last)
+            : data(first, last) {}
+
     // Adds a new item to the end of the container
-    template<typename T>
-    void MyContainer<T>::add(const T& item) {
-        data.push_back(item);
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::add(const T& item) {
+        addIndexed(item);
+        invalidateViews();
     }
 
-    // Removes all occurrences of the given item from the container
-    // Throws an exception if the item is not found
-    template<typename T>
-    void MyContainer<T>::remove(const T& item) {
-        std::vector<T> newData;
-        bool found = false;
-
-        for (const T& val : data) {
-            if (val != item) {
-                newData.push_back(val);
-            } else {
-                found = true;
+    // Indexes item first so a failed index update leaves the storage untouched
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::addIndexed(const T& item) {
+        membership.insert(item);
+        try {
+            data.add(item);
+        } catch (...) {
+            membership.erase(item);
+            throw;
+        }
+    }
+
+    // Constructs a new item in place at the end of the container
+    template<typename T, typename Storage>
+    template<typename... Args>
+    void MyContainer<T, Storage>::emplace(Args&&... args) {
+        if (membership.enabled()) {
+            addIndexed(T(std::forward<Args>(args)...));
+        } else {
+            data.emplace(std::forward<Args>(args)...);
+        }
+        invalidateViews();
+    }
+
+    // Appends all items in [first, last); forward ranges grow the storage once
+    template<typename T, typename Storage>
+    template<typename InputIt>
+    void MyContainer<T, Storage>::addRange(InputIt first, InputIt last) {
+        if (first == last) {
+            return;
+        }
+        if (membership.enabled()) {
+            for (; first != last; ++first) {
+                addIndexed(*first);
             }
+        } else {
+            data.addRange(first, last);
         }
+        invalidateViews();
+    }
 
-        if (!found) {
+    // Reserves storage for at least capacity items so later adds don't reallocate
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::reserve(size_t capacity) {
+        data.reserve(capacity);
+    }
+
+    // Removes all occurrences of the given item from the container
+    // Throws an exception if the item is not found – at once if the membership index rules it out
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::remove(const T& item) {
+        stats::Scope scope(stats::Remove);
+        size_t removed = 0;
+        if (membership.mayContain(item)) {
+            scope.add(data.size());
+            removed = data.removeValue(item);
+        }
+        if (removed == 0) {
             throw std::invalid_argument("Item not found in container.");
         }
+        membership.erase(item, removed);
+        invalidateViews();
+    }
+
+    // Removes every element matching pred in a single pass (in place for VectorStorage)
+    // Returns the number of removed elements (0 is not an error)
+    template<typename T, typename Storage>
+    template<typename Predicate>
+    size_t MyContainer<T, Storage>::removeIf(Predicate pred) {
+        stats::Scope scope(stats::Remove, data.size());
+        size_t removed = 0;
+        if (membership.enabled()) {
+            // The index is only updated once the storage has committed the removal
+            std::vector<T> gone;
+            try {
+                removed = data.removeIf([&pred, &gone](const T& item) {
+                    if (!pred(item)) {
+                        return false;
+                    }
+                    gone.push_back(item);
+                    return true;
+                });
+            } catch (...) {
+                resyncMembership();
+                throw;
+            }
+            for (const T& item : gone) {
+                membership.erase(item);
+            }
+        } else {
+            removed = data.removeIf(pred);
+        }
+        if (removed > 0) {
+            invalidateViews();
+        }
+        return removed;
+    }
+
+    // Removes every occurrence of any of the given values in one pass
+    template<typename T, typename Storage>
+    template<typename... Rest>
+    size_t MyContainer<T, Storage>::removeAll(const T& first, const Rest&... rest) {
+        std::vector<T> values{first, static_cast<const T&>(rest)...};
+        return removeValues(std::move(values));
+    }
+
+    // Removes every occurrence of any value in the given range in one pass
+    template<typename T, typename Storage>
+    template<typename Range, typename>
+    size_t MyContainer<T, Storage>::removeAll(const Range& values) {
+        return removeValues(std::vector<T>(std::begin(values), std::end(values)));
+    }
+
+    // Sorts the distinct values once so each element is matched by binary search:
+    // O(n log m) for m values instead of m separate O(n) scans (O(m log n) for OrderedStorage).
+    // Values the membership index rules out are dropped first; if none remain, nothing is scanned.
+    template<typename T, typename Storage>
+    size_t MyContainer<T, Storage>::removeValues(std::vector<T> values) {
+        values.erase(std::remove_if(values.begin(), values.end(),
+                                    [this](const T& value) { return !membership.mayContain(value); }),
+                     values.end());
+        if (values.empty()) {
+            return 0;
+        }
+        stats::Scope scope(stats::Remove, data.size());
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        size_t removed = 0;
+        if (membership.kind() == Membership::Filter) {
+            // The filter can't tell how many of each value there were, so the scan counts them
+            std::vector<size_t> hits(values.size(), 0);
+            try {
+                removed = data.removeIf([&values, &hits](const T& item) {
+                    auto it = std::lower_bound(values.begin(), values.end(), item);
+                    if (it == values.end() || item < *it) {
+                        return false;
+                    }
+                    ++hits[static_cast<size_t>(it - values.begin())];
+                    return true;
+                });
+            } catch (...) {
+                resyncMembership();
+                throw;
+            }
+            for (size_t i = 0; i < values.size(); ++i) {
+                membership.erase(values[i], hits[i]);
+            }
+        } else {
+            removed = data.removeValues(values);
+            if (membership.kind() == Membership::Exact) {
+                for (const T& value : values) {
+                    membership.erase(value, membership.count(value));
+                }
+            }
+        }
+        if (removed > 0) {
+            invalidateViews();
+        }
+        return removed;
+    }
+
+    template<typename T, typename Storage>
+    const T* MyContainer<T, Storage>::checkedItems(const T* items, size_t count) {
+        if (!items && count > 0) {
+            throw std::invalid_argument("Null items pointer passed to MyContainer.");
+        }
+        return items;
+    }
+
+    // Drops the cached sort index and invalidates borrowing views; rebuilds a membership
+    // filter that has outgrown its size
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::invalidateViews() {
+        sortedCache.index.reset();
+        ++generation.value;
+        if (membership.needsRebuild(data.size())) {
+            setMembershipIndex(membership.kind(), 2 * data.size());
+        }
+    }
+
+    // Rebuilds the membership index from the storage after a removal threw partway –
+    // some matches may already be gone – and invalidates the views
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::resyncMembership() {
+        ++generation.value;
+        sortedCache.index.reset();
+        setMembershipIndex(membership.kind(), data.size());
+    }
+
+    // Replaces the membership index with one of the given mode over the current elements
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::setMembershipIndex(Membership mode, size_t expected) {
+        membership.reset(mode, std::max(expected, data.size()));
+        if (!membership.enabled()) {
+            return;
+        }
+        try {
+            data.forEach([this](const T& item) { membership.insert(item); });
+        } catch (...) {
+            membership.reset(Membership::None, 0);
+            throw;
+        }
+    }
+
+    // True if item is in the container
+    template<typename T, typename Storage>
+    bool MyContainer<T, Storage>::contains(const T& item) const {
+        return count(item) > 0;
+    }
+
+    // Occurrences of item: read from an exact index, else counted by a scan unless a
+    // filter rules item out
+    template<typename T, typename Storage>
+    size_t MyContainer<T, Storage>::count(const T& item) const {
+        if (membership.kind() == Membership::Exact) {
+            return membership.count(item);
+        }
+        if (!membership.mayContain(item)) {
+            return 0;
+        }
+        size_t found = 0;
+        data.forEach([&item, &found](const T& value) {
+            if (value == item) {
+                ++found;
+            }
+        });
+        return found;
+    }
+
+    // Switches between full and lazy sort indices; the next sorted view uses the new mode
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::setLazySort(bool enabled) {
+        if (sortOptions.lazy != enabled) {
+            sortOptions.lazy = enabled;
+            sortedCache.index.reset();
+        }
+    }
+
+    // Switches between value and permutation sort indices; the next sorted view uses the new mode
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::setPermutationSort(bool enabled) {
+        if (sortOptions.permute != enabled) {
+            sortOptions.permute = enabled;
+            sortedCache.index.reset();
+        }
+    }
+
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::dropSortIndex() {
+        sortedCache.index.reset();
+    }
 
-        data = newData;
+    // Changes when and how wide sorts run in parallel; affects the next index built
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::setParallelSort(size_t threshold, unsigned threads) {
+        sortOptions.parallelThreshold = threshold;
+        sortOptions.threads = threads;
+    }
+
+    // Caps the RAM a sort index may use; larger sorts spill runs to directory and merge them
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::setSortMemoryLimit(size_t bytes, const std::string& directory) {
+        sortOptions.memoryLimit = bytes;
+        sortOptions.spillDirectory = directory;
     }
 
     // Returns the current number of items in the container
-    template<typename T>
-    size_t MyContainer<T>::size() const {
+    template<typename T, typename Storage>
+    size_t MyContainer<T, Storage>::size() const {
         return data.size();
     }
 
-    // Output stream operator – prints the container in format: [ item1 item2 ... ]
-    template<typename U>
-    std::ostream& operator<<(std::ostream& os, const MyContainer<U>& container) {
-        os << "[ ";
-        for (const auto& item : container.data) {
-            os << item << " ";
+    // Copies the elements into a buffer allocated from resource
+    template<typename T, typename Storage>
+    ArenaBuffer<T> MyContainer<T, Storage>::itemsIn(std::pmr::memory_resource* resource) const {
+        ArenaBuffer<T> copy(data.size(), resource);
+        if constexpr (Policy::contiguous) {
+            copy.append(data.items().begin(), data.items().end());
+        } else {
+            data.forEach([&copy](const T& item) { copy.push_back(item); });
+        }
+        return copy;
+    }
+
+    // Returns the elements in insertion order as an immutable value
+    template<typename T, typename Storage>
+    typename MyContainer<T, Storage>::Items MyContainer<T, Storage>::snapshot() const {
+        return data.items();
+    }
+
+    // Writes the elements in one block; other storages are copied to a vector first
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::save(const std::string& path, bool withIndex) const {
+        if constexpr (Policy::contiguous) {
+            binary::writeFile(path, data.items().data(), data.size(), withIndex);
+        } else {
+            std::vector<T> items;
+            items.reserve(data.size());
+            data.forEach([&items](const T& item) { items.push_back(item); });
+            binary::writeFile(path, items.data(), items.size(), withIndex);
+        }
+    }
+
+    // Copies the elements out of the mapped file; a stored permutation becomes the
+    // cached sort index (contiguous storage only – others sort on first use)
+    template<typename T, typename Storage>
+    void MyContainer<T, Storage>::load(const std::string& path) {
+        binary::MappedFile file = binary::MappedFile::open<T>(path);
+        const T* items = file.elements<T>();
+        if constexpr (Policy::contiguous) {
+            data = Policy(items, items + file.size(), data.items().get_allocator());
+        } else {
+            data = Policy(items, items + file.size());
         }
-        os << "]";
+        invalidateViews();
+        setMembershipIndex(membership.kind());
+        if constexpr (Policy::contiguous) {
+            if (file.hasPermutation()) {
+                sortedCache.index = std::make_shared<const SortedIndex<T>>(
+                        file.permutationIndex(data.items().data(), &generation.value, sortOptions));
+            }
+        }
+    }
+
+    // Builds the sort index on first use; later calls share it until the next add/remove.
+    // The storage decides how: sort a copy, sort a permutation or walk an ordered tree.
+    // Concurrent const callers wait on the cache lock and share the one index.
+    template<typename T, typename Storage>
+    std::shared_ptr<const SortedIndex<T>> MyContainer<T, Storage>::sortedData() const {
+        std::lock_guard<std::mutex> guard(sortedCache.lock);
+        if (!sortedCache.index) {
+            stats::Scope scope(stats::Sort, data.size());
+            if (!Policy::presorted && SortedIndex<T>::spills(data.size(), sortOptions)) {
+                sortedCache.index = std::make_shared<const SortedIndex<T>>(SortedIndex<T>::bySpilling(
+                        data.size(), [this](auto f) { data.forEach(f); }, sortOptions));
+            } else {
+                sortedCache.index = data.sortIndex(&generation.value, sortOptions);
+            }
+            scope.add(0, sortedCache.index->bytes());
+        }
+        return sortedCache.index;
+    }
+
+    // Output stream operator – prints the container in format: [ item1 item2 ... ]
+    // Arithmetic and string elements are formatted into large blocks (see Formatting.hpp)
+    template<typename U, typename S>
+    std::ostream& operator<<(std::ostream& os, const MyContainer<U, S>& container) {
+        formatting::writeItems<U>(os, [&container](auto f) { container.data.forEach(f); });
         return os;
     }
 
@@ -0,0 +1,249 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_ORDEREDSTORAGE_HPP
+#define EX4_ORDEREDSTORAGE_HPP
+
+#include <list>
+#include <set>
+#include <vector>
+#include <memory>
+#include <utility>
+#include "SortedIndex.hpp"
+
+namespace genericContainer {
+
+    // Always-sorted MyContainer storage policy.
+    // Elements live in a list (insertion order) that is also indexed by value in a
+    // balanced tree, so add and remove(value) are O(log n) and the sorted views
+    // are built by an O(n) in-order walk with no sorting. The ascending copy handed
+    // to the views is kept afterwards and patched with the next few changes instead
+    // of walked again, as long as no view still holds it.
+    template<typename T>
+    class OrderedStorage {
+    private:
+        struct Node;
+        using Sequence = std::list<Node>;
+        using Position = typename Sequence::const_iterator;
+
+        // Orders list positions by the values they refer to.
+        // Transparent, so the tree can be searched with a plain T.
+        struct ByValue {
+            using is_transparent = void;
+
+            bool operator()(Position a, Position b) const { return a->value < b->value; }
+            bool operator()(Position a, const T& b) const { return a->value < b; }
+            bool operator()(const T& a, Position b) const { return a < b->value; }
+        };
+
+        using Sorted = std::multiset<Position, ByValue>;
+
+        // An element and its own entry in the value index, so erasing it needs no search
+        struct Node {
+            T value;
+            typename Sorted::const_iterator entry;
+
+            template<typename... Args>
+            explicit Node(std::in_place_t, Args&&... args)
+                    : value(std::forward<Args>(args)...) {}
+        };
+
+        // Changes patched into the kept ascending copy; more than this and it is rebuilt
+        static constexpr size_t maxPending = 32;
+
+        Sequence sequence;  // Elements in insertion order
+        Sorted sorted;      // Same elements in ascending order (ties by insertion)
+
+        mutable std::shared_ptr<SortedIndex<T>> ascending;    // Last index handed out, if kept
+        mutable std::vector<std::pair<T, bool>> pending;      // (value, added) since it was built
+
+        // Records a change for the kept ascending copy, or drops the copy once too many pile up
+        void note(const T& value, bool added) {
+            if (!ascending) {
+                return;
+            }
+            if (pending.size() == maxPending) {
+                ascending.reset();
+                pending.clear();
+                return;
+            }
+            try {
+                pending.emplace_back(value, added);
+            } catch (...) {
+                ascending.reset();
+                pending.clear();
+            }
+        }
+
+        // Indexes the last element of sequence (dropping it if that fails)
+        void indexBack() {
+            try {
+                sequence.back().entry = sorted.insert(sorted.end(), std::prev(sequence.cend()));
+            } catch (...) {
+                sequence.pop_back();
+                throw;
+            }
+        }
+
+        // Rebuilds the value index from sequence (after copying)
+        void reindex() {
+            sorted.clear();
+            for (auto it = sequence.begin(); it != sequence.end(); ++it) {
+                it->entry = sorted.insert(Position(it));
+            }
+        }
+
+        // Erases one element from both structures – O(log n) however many duplicates it has
+        void erase(Position pos) {
+            note(pos->value, false);
+            sorted.erase(pos->entry);
+            sequence.erase(pos);
+        }
+
+    public:
+        // Borrowing views get an owning copy – the elements are not contiguous
+        static constexpr bool contiguous = false;
+
+        // sortIndex walks the tree – nothing to sort, so nothing to spill
+        static constexpr bool presorted = true;
+
+        // What items() returns
+        using Items = std::vector<T>;
+
+        OrderedStorage() = default;
+
+        // Constructor – copies the range [first, last)
+        template<typename InputIt>
+        OrderedStorage(InputIt first, InputIt last) {
+            addRange(first, last);
+        }
+
+        // Copies need their own index – positions point into the source list
+        OrderedStorage(const OrderedStorage& other)
+                : sequence(other.sequence) {
+            reindex();
+        }
+
+        OrderedStorage& operator=(const OrderedStorage& other) {
+            if (this != &other) {
+                sequence = other.sequence;
+                reindex();
+                ascending.reset();
+                pending.clear();
+            }
+            return *this;
+        }
+
+        // Moving a list keeps its positions valid
+        OrderedStorage(OrderedStorage&&) = default;
+        OrderedStorage& operator=(OrderedStorage&&) = default;
+
+        void add(const T& item) {
+            sequence.emplace_back(std::in_place, item);
+            indexBack();
+            note(item, true);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            sequence.emplace_back(std::in_place, std::forward<Args>(args)...);
+            indexBack();
+            note(sequence.back().value, true);
+        }
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                add(*first);
+            }
+        }
+
+        // Nothing to reserve for node-based storage
+        void reserve(size_t) {}
+
+        size_t size() const {
+            return sequence.size();
+        }
+
+        // O(n) scan; each match is unlinked through its own index entry, with no search among duplicates
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
+            size_t removed = 0;
+            for (auto it = sequence.cbegin(); it != sequence.cend();) {
+                auto current = it++;
+                if (pred(current->value)) {
+                    erase(current);
+                    ++removed;
+                }
+            }
+            return removed;
+        }
+
+        // O(log n + k) for k matches – no scan of the container
+        size_t removeValue(const T& item) {
+            size_t removed = 0;
+            auto range = sorted.equal_range(item);
+            for (auto it = range.first; it != range.second;) {
+                Position pos = *it;
+                note(pos->value, false);
+                it = sorted.erase(it);
+                sequence.erase(pos);
+                ++removed;
+            }
+            return removed;
+        }
+
+        // O(m log n + k) for m values with k matches
+        size_t removeValues(const std::vector<T>& sortedValues) {
+            size_t removed = 0;
+            for (const T& value : sortedValues) {
+                removed += removeValue(value);
+            }
+            return removed;
+        }
+
+        // Elements in insertion order (a copy)
+        std::vector<T> items() const {
+            std::vector<T> result;
+            result.reserve(sequence.size());
+            for (const Node& node : sequence) {
+                result.push_back(node.value);
+            }
+            return result;
+        }
+
+        // Calls f on every element in insertion order
+        template<typename Function>
+        void forEach(Function f) const {
+            for (const Node& node : sequence) {
+                f(node.value);
+            }
+        }
+
+        // Already sorted, so the sort options don't apply. Patches the last index with the
+        // changes since, O(n) moves and no allocation per change, if no view still holds it;
+        // else walks the tree in order into a new one.
+        std::shared_ptr<const SortedIndex<T>> sortIndex(const size_t*, const SortOptions&) const {
+            if (ascending && ascending.use_count() == 1) {
+                for (const auto& change : pending) {
+                    if (change.second) {
+                        ascending->insertSorted(change.first);
+                    } else {
+                        ascending->eraseSorted(change.first);
+                    }
+                }
+            } else {
+                std::vector<T> values;
+                values.reserve(sorted.size());
+                for (Position pos : sorted) {
+                    values.push_back(pos->value);
+                }
+                ascending = std::make_shared<SortedIndex<T>>(SortedIndex<T>::fromSorted(std::move(values)));
+            }
+            pending.clear();
+            return ascending;
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_ORDEREDSTORAGE_HPP
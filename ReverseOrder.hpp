@@ -4,46 +4,78 @@
 #define EX4_REVERSEORDER_HPP
 
 #include <vector>
+#include <utility>
+#include <cstddef>
+#include <iterator>
 #include <algorithm>
 #include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "GenerationGuard.hpp"
 
 namespace genericContainer {
 
     // Template class for iterating through a container in reverse order
-    template<typename T>
+    // Source is the element sequence: std::vector<T>, or an O(1)-copy ChunkedSnapshot<T>
+    template<typename T, typename Checks = DefaultIteratorChecks, typename Source = std::vector<T>>
     class ReverseOrder {
     private:
-        std::vector<T> dataCopy;  // Stores a copy of the original data
+        Source dataCopy;         // Stores a copy of the original data (owning views)
+        const Source* borrowed;  // Container data iterated in place (borrowing views)
+        GenerationGuard guard;   // Detects a borrowed container being modified
+
+        // Data the iterators walk over
+        const Source* items() const {
+            return borrowed ? borrowed : &dataCopy;
+        }
 
     public:
-        // Nested iterator class
+        // Nested iterator class – a standard random access iterator
         class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
         private:
-            const std::vector<T>* data;  // Pointer to the copied data
+            const Source* data;  // Pointer to the copied data
             size_t index;                // Index from the back (0 is last element, size-1 is first)
+            GenerationGuard guard;       // Validity of borrowed data
+
+            // Underlying position of the element visited at step p
+            size_t position(size_t p) const {
+                return data->size() - 1 - p;
+            }
 
         public:
+            // Default constructor – singular iterator, only assignable
+            Iterator() : data(nullptr), index(0) {}
+
             // Constructor
-            Iterator(const std::vector<T>* data, size_t index)
-                    : data(data), index(index) {
-                if (!data) {
-                    throw std::invalid_argument("Null data pointer passed to ReverseOrder iterator.");
-                }
+            Iterator(const Source* data, size_t index, GenerationGuard guard = GenerationGuard())
+                    : data(data), index(index), guard(guard) {
+                failIf<Checks, std::invalid_argument>(!data,
+                                                      "Null data pointer passed to ReverseOrder iterator.");
             }
 
             // Dereference operator
-            const T& operator*() const {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Dereferencing out of bounds in ReverseOrder.");
-                }
-                return data->at(data->size() - 1 - index);
+            reference operator*() const {
+                guard.check<Checks>();
+                failIf<Checks, std::out_of_range>(index >= data->size(),
+                                                  "Dereferencing out of bounds in ReverseOrder.");
+                return (*data)[position(index)];
+            }
+
+            // Member access (it->member)
+            pointer operator->() const {
+                return &**this;
             }
 
             // Prefix increment (++it)
             Iterator& operator++() {
-                if (index >= data->size()) {
-                    throw std::out_of_range("Cannot increment beyond end in ReverseOrder.");
-                }
+                failIf<Checks, std::out_of_range>(index >= data->size(),
+                                                  "Cannot increment beyond end in ReverseOrder.");
                 ++index;
                 return *this;
             }
@@ -57,9 +89,7 @@ namespace genericContainer {
 
             // Prefix decrement (--it)
             Iterator& operator--() {
-                if (index == 0) {
-                    throw std::out_of_range("Cannot decrement before beginning.");
-                }
+                failIf<Checks, std::out_of_range>(index == 0, "Cannot decrement before beginning.");
                 --index;
                 return *this;
             }
@@ -71,75 +101,107 @@ namespace genericContainer {
                 return temp;
             }
 
-            // Random access: it[n]
-            const T& operator[](size_t offset) const {
-                if (index + offset >= data->size()) {
-                    throw std::out_of_range("Random access out of bounds in ReverseOrder.");
-                }
-                return data->at(data->size() - 1 - (index + offset));
+            // Random access (it[n]) – O(1), n may be negative
+            reference operator[](difference_type offset) const {
+                guard.check<Checks>();
+                difference_type target = static_cast<difference_type>(index) + offset;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) >= data->size(),
+                                                  "Random access out of bounds in ReverseOrder.");
+                return (*data)[position(static_cast<size_t>(target))];
             }
 
-            // it + n
-            Iterator operator+(int n) const {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator + offset out of range.");
-                }
-                return Iterator(data, index + n);
+            // Add and assign (it += n) – O(1), n may be negative
+            Iterator& operator+=(difference_type n) {
+                difference_type target = static_cast<difference_type>(index) + n;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) > data->size(),
+                                                  "Iterator += out of range.");
+                index = static_cast<size_t>(target);
+                return *this;
             }
 
-            // it - n
-            Iterator operator-(int n) const {
-                if (n > index) {
-                    throw std::out_of_range("Iterator - offset out of range.");
-                }
-                return Iterator(data, index - n);
+            // Subtract and assign (it -= n)
+            Iterator& operator-=(difference_type n) {
+                return *this += -n;
             }
 
-            // it += n
-            Iterator& operator+=(int n) {
-                if (index + n > data->size()) {
-                    throw std::out_of_range("Iterator += out of range.");
-                }
-                index += n;
-                return *this;
+            // Jump forward (it + n)
+            Iterator operator+(difference_type n) const {
+                Iterator result = *this;
+                result += n;
+                return result;
             }
 
-            // it -= n
-            Iterator& operator-=(int n) {
-                if (n > index) {
-                    throw std::out_of_range("Iterator -= out of range.");
-                }
-                index -= n;
-                return *this;
+            // Jump forward (n + it)
+            friend Iterator operator+(difference_type n, const Iterator& it) {
+                return it + n;
             }
 
-            // Inequality comparison
-            bool operator!=(const Iterator& other) const {
-                return index != other.index || data != other.data;
+            // Jump backward (it - n)
+            Iterator operator-(difference_type n) const {
+                Iterator result = *this;
+                result -= n;
+                return result;
+            }
+
+            // Distance between two iterators of the same view (it - other) – O(1)
+            difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
             }
 
             // Equality comparison
             bool operator==(const Iterator& other) const {
                 return index == other.index && data == other.data;
             }
+
+            // Inequality comparison
+            bool operator!=(const Iterator& other) const {
+                return !(*this == other);
+            }
+
+            // Ordering – iterators of the same view compare by step
+            bool operator<(const Iterator& other) const {
+                return index < other.index;
+            }
+
+            bool operator>(const Iterator& other) const {
+                return other < *this;
+            }
+
+            bool operator<=(const Iterator& other) const {
+                return !(other < *this);
+            }
+
+            bool operator>=(const Iterator& other) const {
+                return !(*this < other);
+            }
         };
 
-        // Constructor – makes a copy of the input vector
-        ReverseOrder(const std::vector<T>& original)
-                : dataCopy(original) {
+        // Constructor – takes a copy of the original (O(1) for a ChunkedSnapshot; an
+        // rvalue, e.g. a vector allocated from an arena, is moved in with its allocator)
+        ReverseOrder(Source original)
+                : dataCopy(std::move(original)), borrowed(nullptr) {
             if (dataCopy.empty()) {
                 throw std::invalid_argument("ReverseOrder cannot be created on an empty container.");
             }
         }
 
+        // Constructor – borrows the original without copying;
+        // iterators throw std::logic_error once *generation changes
+        ReverseOrder(const Source& original, const size_t* generation)
+                : borrowed(&original), guard(generation) {
+            if (original.empty()) {
+                throw std::invalid_argument("ReverseOrder cannot be created on an empty container.");
+            }
+        }
+
         // Begin iterator – starts at index 0 (points to last element in actual data)
         Iterator begin() const {
-            return Iterator(&dataCopy, 0);
+            return Iterator(items(), 0, guard);
         }
 
-        // End iterator – one past the first element (dataCopy.size())
+        // End iterator – one past the first element (items()->size())
         Iterator end() const {
-            return Iterator(&dataCopy, dataCopy.size());
+            return Iterator(items(), items()->size(), guard);
         }
     };
 
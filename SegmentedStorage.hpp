@@ -0,0 +1,237 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_SEGMENTEDSTORAGE_HPP
+#define EX4_SEGMENTEDSTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "SortedIndex.hpp"
+
+namespace genericContainer {
+
+    // MyContainer storage policy with worst-case O(1) add, for large containers that
+    // must not stall. Elements live in fixed-size chunks that never move; chunks are
+    // found through a two-level directory whose top level is allocated once, so no add
+    // copies elements or grows a table. Capacity is 2^34 elements.
+    template<typename T>
+    class SegmentedStorage {
+    private:
+        static constexpr size_t chunkBits = 12;  // Elements per chunk
+        static constexpr size_t pageBits = 12;   // Chunk pointers per directory page
+        static constexpr size_t topBits = 10;    // Directory pages
+        static constexpr size_t chunkSize = size_t(1) << chunkBits;
+        static constexpr size_t pageSize = size_t(1) << pageBits;
+        static constexpr size_t topSize = size_t(1) << topBits;
+        static constexpr size_t maxChunks = topSize * pageSize;
+
+        using Page = std::unique_ptr<T*[]>;
+
+        std::unique_ptr<Page[]> directory;  // topSize pages, allocated with the first chunk
+        size_t chunks = 0;                  // Chunks allocated; kept after removals for reuse
+        size_t count = 0;
+
+        T*& chunkAt(size_t chunk) const {
+            return directory[chunk >> pageBits][chunk & (pageSize - 1)];
+        }
+
+        T& slot(size_t i) const {
+            return chunkAt(i >> chunkBits)[i & (chunkSize - 1)];
+        }
+
+        // Allocates one more chunk (and its directory page if it starts one)
+        void grow() {
+            if (chunks == maxChunks) {
+                throw std::length_error("SegmentedStorage is full.");
+            }
+            if (!directory) {
+                directory.reset(new Page[topSize]());
+            }
+            Page& page = directory[chunks >> pageBits];
+            if (!page) {
+                page.reset(new T*[pageSize]());
+            }
+            page[chunks & (pageSize - 1)] = std::allocator<T>().allocate(chunkSize);
+            ++chunks;
+        }
+
+        template<typename... Args>
+        void append(Args&&... args) {
+            if (count == chunks * chunkSize) {
+                grow();
+            }
+            ::new (static_cast<void*>(&slot(count))) T(std::forward<Args>(args)...);
+            ++count;
+        }
+
+        // Destroys the elements from position first on
+        void truncate(size_t first) {
+            for (size_t i = first; i < count; ++i) {
+                slot(i).~T();
+            }
+            count = std::min(count, first);
+        }
+
+        void release() {
+            truncate(0);
+            for (size_t c = 0; c < chunks; ++c) {
+                std::allocator<T>().deallocate(chunkAt(c), chunkSize);
+            }
+            directory.reset();
+            chunks = 0;
+        }
+
+    public:
+        // Borrowing views get an owning copy – the elements are not contiguous
+        static constexpr bool contiguous = false;
+
+        // sortIndex may sort (and spill under a memory limit)
+        static constexpr bool presorted = false;
+
+        // What items() returns
+        using Items = std::vector<T>;
+
+        SegmentedStorage() = default;
+
+        // Constructor – copies the range [first, last)
+        template<typename InputIt>
+        SegmentedStorage(InputIt first, InputIt last) {
+            try {
+                addRange(first, last);
+            } catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        SegmentedStorage(const SegmentedStorage& other) {
+            try {
+                other.forEach([this](const T& item) { append(item); });
+            } catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        SegmentedStorage& operator=(const SegmentedStorage& other) {
+            if (this != &other) {
+                SegmentedStorage copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        SegmentedStorage(SegmentedStorage&& other) noexcept {
+            swap(other);
+        }
+
+        SegmentedStorage& operator=(SegmentedStorage&& other) noexcept {
+            if (this != &other) {
+                release();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~SegmentedStorage() {
+            release();
+        }
+
+        void swap(SegmentedStorage& other) noexcept {
+            std::swap(directory, other.directory);
+            std::swap(chunks, other.chunks);
+            std::swap(count, other.count);
+        }
+
+        void add(const T& item) {
+            append(item);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            append(std::forward<Args>(args)...);
+        }
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                append(*first);
+            }
+        }
+
+        // Allocates the chunks for capacity elements up front, so later adds skip the allocator
+        void reserve(size_t capacity) {
+            while (chunks * chunkSize < capacity) {
+                grow();
+            }
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        // Stable in-place compaction, O(n); pred runs once per element. Returns the number removed.
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
+            size_t kept = 0;
+            for (size_t i = 0; i < count; ++i) {
+                T& item = slot(i);
+                if (pred(static_cast<const T&>(item))) {
+                    continue;
+                }
+                if (kept != i) {
+                    slot(kept) = std::move(item);
+                }
+                ++kept;
+            }
+            size_t removed = count - kept;
+            truncate(kept);
+            return removed;
+        }
+
+        // Removes every element equal to item
+        size_t removeValue(const T& item) {
+            return removeIf([&item](const T& val) { return val == item; });
+        }
+
+        // Removes every element equal to one of sortedValues (sorted, distinct)
+        size_t removeValues(const std::vector<T>& sortedValues) {
+            return removeIf([&sortedValues](const T& val) {
+                return std::binary_search(sortedValues.begin(), sortedValues.end(), val);
+            });
+        }
+
+        // Elements in insertion order (a copy)
+        std::vector<T> items() const {
+            std::vector<T> result;
+            result.reserve(count);
+            for (size_t c = 0; c * chunkSize < count; ++c) {
+                const T* chunk = chunkAt(c);
+                result.insert(result.end(), chunk, chunk + std::min(chunkSize, count - c * chunkSize));
+            }
+            return result;
+        }
+
+        // Calls f on every element in insertion order
+        template<typename Function>
+        void forEach(Function f) const {
+            for (size_t c = 0; c * chunkSize < count; ++c) {
+                const T* chunk = chunkAt(c);
+                const T* end = chunk + std::min(chunkSize, count - c * chunkSize);
+                for (const T* item = chunk; item != end; ++item) {
+                    f(*item);
+                }
+            }
+        }
+
+        // Sorts a copy of the values – a permutation index needs contiguous storage
+        std::shared_ptr<const SortedIndex<T>> sortIndex(const size_t*, const SortOptions& options) const {
+            return std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(items(), options));
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_SEGMENTEDSTORAGE_HPP
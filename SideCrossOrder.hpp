@@ -4,64 +4,77 @@
 #define EX4_SIDECROSSORDER_HPP
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <algorithm>
 #include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
 
 namespace genericContainer {
 
     // Template class for iterating through a container in "side-cross" order:
     // leftmost, rightmost, next-left, next-right, etc.
-    template<typename T>
+    template<typename T, typename Checks = DefaultIteratorChecks>
     class SideCrossOrder {
     private:
-        std::vector<T> sortedData;  // Sorted data to iterate over
+        std::shared_ptr<const SortedIndex<T>> sortedData;  // Sorted data to iterate over (may be shared)
 
     public:
-        // Nested iterator class
+        // Nested iterator class – a standard random access iterator
         class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
         private:
-            const std::vector<T>* data;
-            size_t left;
-            size_t right;
-            bool leftTurn;
-            size_t count;
+            const SortedIndex<T>* data;  // Pointer to the sort index
+            size_t count;                // Elements visited so far
+            GenerationGuard guard;       // Validity of a permutation index
+
+            // Underlying position of the element visited at step p
+            size_t position(size_t p) const {
+                // Even steps walk in from the left, odd steps in from the right
+                return p % 2 == 0 ? p / 2 : data->size() - 1 - p / 2;
+            }
 
         public:
+            // Default constructor – singular iterator, only assignable
+            Iterator() : data(nullptr), count(0) {}
+
             // Constructor
-            Iterator(const std::vector<T>* data, bool end = false)
+            Iterator(const SortedIndex<T>* data, bool end = false)
                     : data(data),
-                      left(0),
-                      right(data ? data->size() - 1 : 0),
-                      leftTurn(true),
-                      count(0) {
-                if (!data) {
-                    throw std::invalid_argument("Null data pointer passed to SideCrossOrder iterator.");
-                }
+                      count(0),
+                      guard(data ? data->generationGuard() : GenerationGuard()) {
+                failIf<Checks, std::invalid_argument>(!data,
+                                                      "Null data pointer passed to SideCrossOrder iterator.");
                 if (end) {
                     count = data->size();  // mark as finished
                 }
             }
 
             // Dereference operator
-            const T& operator*() const {
-                if (count >= data->size()) {
-                    throw std::out_of_range("Dereferencing out of range in SideCrossOrder.");
-                }
-                return leftTurn ? data->at(left) : data->at(right);
+            reference operator*() const {
+                guard.check<Checks>();
+                failIf<Checks, std::out_of_range>(count >= data->size(),
+                                                  "Dereferencing out of range in SideCrossOrder.");
+                return (*data)[position(count)];
+            }
+
+            // Member access (it->member)
+            pointer operator->() const {
+                return &**this;
             }
 
             // Prefix increment (++it)
             Iterator& operator++() {
-                if (count >= data->size()) {
-                    throw std::out_of_range("Increment past end in SideCrossOrder.");
-                }
-                if (leftTurn) {
-                    ++left;
-                } else {
-                    if (right == 0) right = -1; // avoid unsigned underflow
-                    else --right;
-                }
-                leftTurn = !leftTurn;
+                failIf<Checks, std::out_of_range>(count >= data->size(),
+                                                  "Increment past end in SideCrossOrder.");
                 ++count;
                 return *this;
             }
@@ -75,17 +88,8 @@ namespace genericContainer {
 
             // Prefix decrement (--it)
             Iterator& operator--() {
-                if (count == 0) {
-                    throw std::out_of_range("Cannot decrement before beginning.");
-                }
-
+                failIf<Checks, std::out_of_range>(count == 0, "Cannot decrement before beginning.");
                 --count;
-                leftTurn = !leftTurn;
-                if (!leftTurn) {
-                    --left;
-                } else {
-                    ++right;
-                }
                 return *this;
             }
 
@@ -96,70 +100,102 @@ namespace genericContainer {
                 return temp;
             }
 
-            // Random access (it[n])
-            const T& operator[](size_t offset) const {
-                if (count + offset >= data->size()) {
-                    throw std::out_of_range("Random access out of range.");
-                }
+            // Random access (it[n]) – O(1), n may be negative
+            reference operator[](difference_type offset) const {
+                guard.check<Checks>();
+                difference_type target = static_cast<difference_type>(count) + offset;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) >= data->size(),
+                                                  "Random access out of range.");
+                return (*data)[position(static_cast<size_t>(target))];
+            }
 
-                // Simulate the zigzag pattern for index + offset
-                size_t virtualCount = count + offset;
-                bool even = (virtualCount % 2 == 0);
-                size_t pos = virtualCount / 2;
-                return even ? data->at(pos) : data->at(data->size() - 1 - pos);
+            // Add and assign (it += n) – O(1), n may be negative
+            Iterator& operator+=(difference_type n) {
+                difference_type target = static_cast<difference_type>(count) + n;
+                failIf<Checks, std::out_of_range>(target < 0 || static_cast<size_t>(target) > data->size(),
+                                                  "Iterator += out of range.");
+                count = static_cast<size_t>(target);
+                return *this;
+            }
+
+            // Subtract and assign (it -= n)
+            Iterator& operator-=(difference_type n) {
+                return *this += -n;
             }
 
-            // Jump forward
-            Iterator operator+(int n) const {
+            // Jump forward (it + n)
+            Iterator operator+(difference_type n) const {
                 Iterator result = *this;
                 result += n;
                 return result;
             }
 
-            // Jump backward
-            Iterator operator-(int n) const {
+            // Jump forward (n + it)
+            friend Iterator operator+(difference_type n, const Iterator& it) {
+                return it + n;
+            }
+
+            // Jump backward (it - n)
+            Iterator operator-(difference_type n) const {
                 Iterator result = *this;
                 result -= n;
                 return result;
             }
 
-            // Add and assign
-            Iterator& operator+=(int n) {
-                for (int i = 0; i < n; ++i) ++(*this);
-                return *this;
+            // Distance between two iterators of the same view (it - other) – O(1)
+            difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(count) - static_cast<difference_type>(other.count);
             }
 
-            // Subtract and assign
-            Iterator& operator-=(int n) {
-                for (int i = 0; i < n; ++i) --(*this);
-                return *this;
+            // Equality comparison
+            bool operator==(const Iterator& other) const {
+                return count == other.count && data == other.data;
             }
 
             // Inequality comparison
             bool operator!=(const Iterator& other) const {
-                return count != other.count || data != other.data;
+                return !(*this == other);
             }
 
-            // Equality comparison
-            bool operator==(const Iterator& other) const {
-                return count == other.count && data == other.data;
+            // Ordering – iterators of the same view compare by step
+            bool operator<(const Iterator& other) const {
+                return count < other.count;
+            }
+
+            bool operator>(const Iterator& other) const {
+                return other < *this;
+            }
+
+            bool operator<=(const Iterator& other) const {
+                return !(other < *this);
+            }
+
+            bool operator>=(const Iterator& other) const {
+                return !(*this < other);
             }
         };
 
         // Constructor: sort data
         SideCrossOrder(const std::vector<T>& original) {
-            sortedData = original;
-            std::sort(sortedData.begin(), sortedData.end());
+            sortedData = std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(original));
+        }
+
+        // Constructor: shares an existing sort index (no copy, no sort)
+        explicit SideCrossOrder(std::shared_ptr<const SortedIndex<T>> sorted)
+                : sortedData(std::move(sorted)) {
+            if (!sortedData) {
+                throw std::invalid_argument("Null sorted data passed to SideCrossOrder.");
+            }
         }
 
         // Begin iterator
         Iterator begin() const {
-            return Iterator(&sortedData);
+            return Iterator(sortedData.get());
         }
 
         // End iterator
         Iterator end() const {
-            return Iterator(&sortedData, true);
+            return Iterator(sortedData.get(), true);
         }
     };
 
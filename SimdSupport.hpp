@@ -0,0 +1,26 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_SIMDSUPPORT_HPP
+#define EX4_SIMDSUPPORT_HPP
+
+// SIMD kernels need GCC/Clang on x86; define MYCONTAINER_NO_SIMD to force the scalar paths
+#if !defined(MYCONTAINER_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define MYCONTAINER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace genericContainer {
+
+#ifdef MYCONTAINER_SIMD_X86
+    // True when the CPU runs AVX2 kernels (compiled with a target attribute, so the
+    // build itself needs no -mavx2). Checked once per process.
+    inline bool cpuHasAvx2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+
+} // namespace genericContainer
+
+#endif // EX4_SIMDSUPPORT_HPP
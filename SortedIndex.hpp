@@ -0,0 +1,319 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_SORTEDINDEX_HPP
+#define EX4_SORTEDINDEX_HPP
+
+#include <vector>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include "GenerationGuard.hpp"
+#include "Sorting.hpp"
+#include "ExternalSort.hpp"
+
+namespace genericContainer {
+
+    // Chooses how MyContainer builds its sort index for T.
+    // false – sort a copy of the values (default): sorted views own their data and keep
+    //         working after the container changes or is destroyed
+    // true  – sort a permutation of positions (4–8 bytes per element, no copies of T);
+    //         the views then borrow the container's storage and throw once it changes.
+    // Specialize for your own types to opt in, or call MyContainer::setPermutationSort(true).
+    template<typename T>
+    struct SortsByIndex : std::false_type {};
+
+    // Elements of a container in ascending order, shared by the sorted views.
+    // Holds either sorted copies of the values or a permutation into the container's storage.
+    // A lazy index starts unsorted and settles only the positions that are read.
+    template<typename T>
+    class SortedIndex {
+    private:
+        // Unsettled ranges at most this long are finished with one std::sort
+        static constexpr size_t lazyCutoff = 32;
+
+        // Keys are reordered by lazy settling, hence mutable
+        mutable std::vector<T> values;               // Value mode: sorted copy
+        const T* base;                               // Permutation mode: container elements
+        bool permuted;                               // False in value mode
+        const T* spilled;                            // Spilled mode: sorted values in a mapped file
+        size_t spilledCount;
+        mutable std::vector<uint32_t> narrowOrder;   // Permutation when positions fit in 32 bits
+        mutable std::vector<size_t> wideOrder;       // Permutation for larger containers
+        mutable std::map<size_t, size_t> unsettled;  // Lazy mode: [first, last) ranges not yet in final order
+
+        // Lazy mode: settling is serialized, since the index is shared by views on any thread.
+        // A settled position never moves again, so it is read without the lock.
+        struct Settling {
+            std::mutex lock;
+            std::atomic<bool> done{false};  // Set once nothing is unsettled
+        };
+        std::unique_ptr<Settling> settling;
+        GenerationGuard guard;                       // Detects the permuted storage being modified
+        std::shared_ptr<const void> owner;           // Keeps permuted data alive (e.g. a mapped file)
+
+        SortedIndex() : base(nullptr), permuted(false), spilled(nullptr), spilledCount(0) {}
+
+        // Marks the whole index unsettled (lazy mode)
+        void deferSort() {
+            if (size() > 1) {
+                unsettled.emplace(0, size());
+                settling = std::make_unique<Settling>();
+            }
+        }
+
+        // Incremental quicksort: partitions the unsettled range holding position i
+        // (three-way, so runs of equal keys settle at once) and keeps only the side
+        // containing i. Reading the first k positions costs O(n + k log k) expected.
+        template<typename Key, typename Less>
+        void settle(std::vector<Key>& keys, Less less, size_t i) const {
+            auto range = unsettled.upper_bound(i);
+            if (range == unsettled.begin()) {
+                return;
+            }
+            --range;
+            size_t first = range->first;
+            size_t last = range->second;
+            if (i >= last) {
+                return;
+            }
+            unsettled.erase(range);
+
+            while (last - first > lazyCutoff) {
+                const Key& a = keys[first];
+                const Key& b = keys[first + (last - first) / 2];
+                const Key& c = keys[last - 1];
+                Key pivot = less(a, b) ? (less(b, c) ? b : (less(a, c) ? c : a))
+                                       : (less(a, c) ? a : (less(b, c) ? c : b));
+
+                auto lowEnd = std::partition(keys.begin() + first, keys.begin() + last,
+                                             [&](const Key& k) { return less(k, pivot); });
+                auto highBegin = std::partition(lowEnd, keys.begin() + last,
+                                                [&](const Key& k) { return !less(pivot, k); });
+                size_t low = static_cast<size_t>(lowEnd - keys.begin());
+                size_t high = static_cast<size_t>(highBegin - keys.begin());
+
+                // [low, high) holds keys equal to the pivot – already final
+                if (i < low) {
+                    if (high < last) unsettled.emplace(high, last);
+                    last = low;
+                } else if (i >= high) {
+                    if (first < low) unsettled.emplace(first, low);
+                    first = high;
+                } else {
+                    if (first < low) unsettled.emplace(first, low);
+                    if (high < last) unsettled.emplace(high, last);
+                    return;
+                }
+            }
+            std::sort(keys.begin() + first, keys.begin() + last, less);
+        }
+
+        // Ensures position i holds its final element
+        void settle(size_t i) const {
+            if (!settling || settling->done.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::lock_guard<std::mutex> guard(settling->lock);
+            if (!permuted) {
+                settle(values, [](const T& a, const T& b) { return a < b; }, i);
+            } else if (!narrowOrder.empty()) {
+                const T* data = base;
+                settle(narrowOrder, [data](uint32_t a, uint32_t b) { return data[a] < data[b]; }, i);
+            } else {
+                const T* data = base;
+                settle(wideOrder, [data](size_t a, size_t b) { return data[a] < data[b]; }, i);
+            }
+            if (unsettled.empty()) {
+                settling->done.store(true, std::memory_order_release);
+            }
+        }
+
+    public:
+        // Fills order with 0..n-1, sorted by the values they point at unless lazy
+        template<typename Index>
+        static void sortPositions(const T* data, size_t n, std::vector<Index>& order,
+                                  const SortOptions& options) {
+            order.resize(n);
+            for (size_t i = 0; i < order.size(); ++i) {
+                order[i] = static_cast<Index>(i);
+            }
+            if (!options.lazy) {
+                sortKeys(order, [data](Index a, Index b) { return data[a] < data[b]; }, options);
+            }
+        }
+
+        // Builds an index holding a sorted copy of data
+        // (lazy: copied now, sorted as positions are read)
+        static SortedIndex byValue(std::vector<T> data, const SortOptions& options = SortOptions()) {
+            SortedIndex index;
+            index.values = std::move(data);
+            if (options.lazy) {
+                index.deferSort();
+            } else {
+                sortKeys(index.values, std::less<T>(), options);
+            }
+            return index;
+        }
+
+        // True if options (or SortsByIndex<T>) ask for a permutation index
+        static bool permutes(const SortOptions& options) {
+            return options.permute || SortsByIndex<T>::value;
+        }
+
+        // Bytes a sort of count elements holds in RAM (the copy or permutation plus scratch)
+        static size_t sortBytes(size_t count, const SortOptions& options) {
+            return count * (permutes(options) ? 2 * sizeof(uint32_t) : 2 * sizeof(T));
+        }
+
+        // True if options.memoryLimit is too small for sorting count elements in RAM
+        // (only trivially copyable T are spilled)
+        static bool spills(size_t count, const SortOptions& options) {
+            return std::is_trivially_copyable<T>::value && options.memoryLimit > 0 && count > 0 &&
+                   sortBytes(count, options) > options.memoryLimit;
+        }
+
+        // Sorts the count elements forEach(f) visits on disk within options.memoryLimit
+        // (see ExternalSort.hpp); the index reads the merged result through a mapping
+        template<typename ForEach>
+        static SortedIndex bySpilling(size_t count, ForEach forEach, const SortOptions& options) {
+            SortedIndex index;
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                index.owner = external::sortToFile<T>(count, forEach, options);
+                index.spilled = static_cast<const T*>(index.owner.get());
+                index.spilledCount = count;
+            }
+            return index;
+        }
+
+        // Wraps values that are already in ascending order (no sort)
+        static SortedIndex fromSorted(std::vector<T> sortedValues) {
+            SortedIndex index;
+            index.values = std::move(sortedValues);
+            return index;
+        }
+
+        // Builds a permutation over data (any allocator) without copying any element.
+        // data must outlive the index; access throws once *generation changes.
+        template<typename Alloc>
+        static SortedIndex byPermutation(const std::vector<T, Alloc>& data, const size_t* generation = nullptr,
+                                         const SortOptions& options = SortOptions()) {
+            return byPermutation(data.data(), data.size(), generation, options);
+        }
+
+        // Permutation over count elements at data; owner, if given, is held as long as the index
+        static SortedIndex byPermutation(const T* data, size_t count, const size_t* generation,
+                                         const SortOptions& options, std::shared_ptr<const void> owner = nullptr) {
+            SortedIndex index;
+            index.base = data;
+            index.permuted = true;
+            index.guard = GenerationGuard(generation);
+            index.owner = std::move(owner);
+            if (count <= std::numeric_limits<uint32_t>::max()) {
+                sortPositions(index.base, count, index.narrowOrder, options);
+            } else {
+                sortPositions(index.base, count, index.wideOrder, options);
+            }
+            if (options.lazy) {
+                index.deferSort();
+            }
+            return index;
+        }
+
+        // Index from a precomputed ascending order of the count elements at data (no sort):
+        // a copy of the permutation if options permute (see permutes), else the values
+        // gathered in order. Throws std::out_of_range if an entry is not a position below count.
+        template<typename Index>
+        static SortedIndex fromPermutation(const T* data, const Index* order, size_t count,
+                                           const size_t* generation, const SortOptions& options,
+                                           std::shared_ptr<const void> owner = nullptr) {
+            for (size_t i = 0; i < count; ++i) {
+                if (order[i] >= count) {
+                    throw std::out_of_range("Permutation entry out of range.");
+                }
+            }
+            SortedIndex index;
+            if (!permutes(options)) {
+                index.values.reserve(count);
+                for (size_t i = 0; i < count; ++i) {
+                    index.values.push_back(data[order[i]]);
+                }
+                return index;
+            }
+            index.base = data;
+            index.permuted = true;
+            index.guard = GenerationGuard(generation);
+            index.owner = std::move(owner);
+            if (count <= std::numeric_limits<uint32_t>::max()) {
+                index.narrowOrder.assign(order, order + count);
+            } else {
+                index.wideOrder.assign(order, order + count);
+            }
+            return index;
+        }
+
+        // Value mode: keeps the sorted copy in step with one added value – O(n) moves
+        void insertSorted(const T& value) {
+            values.insert(std::upper_bound(values.begin(), values.end(), value), value);
+        }
+
+        // Value mode: keeps the sorted copy in step with one removed value – O(n) moves
+        void eraseSorted(const T& value) {
+            values.erase(std::lower_bound(values.begin(), values.end(), value));
+        }
+
+        // Number of elements
+        size_t size() const {
+            if (spilled) return spilledCount;
+            if (!permuted) return values.size();
+            return narrowOrder.empty() ? wideOrder.size() : narrowOrder.size();
+        }
+
+        // True if this index dereferences through a permutation
+        bool isPermutation() const {
+            return permuted;
+        }
+
+        // Heap bytes held by the sorted copy or the permutation
+        size_t bytes() const {
+            return values.capacity() * sizeof(T) + narrowOrder.capacity() * sizeof(uint32_t) +
+                   wideOrder.capacity() * sizeof(size_t);
+        }
+
+        // Guard of the permuted storage (always valid in value mode)
+        const GenerationGuard& generationGuard() const {
+            return guard;
+        }
+
+        // True once every position holds its final element
+        bool isFullySorted() const {
+            return !settling || settling->done.load(std::memory_order_acquire);
+        }
+
+        // Unchecked access to the i-th smallest element
+        const T& operator[](size_t i) const {
+            settle(i);
+            if (!permuted) return spilled ? spilled[i] : values[i];
+            return base[narrowOrder.empty() ? wideOrder[i] : narrowOrder[i]];
+        }
+
+        // Checked access to the i-th smallest element
+        const T& at(size_t i) const {
+            guard.check();
+            if (i >= size()) {
+                throw std::out_of_range("SortedIndex access out of range.");
+            }
+            return (*this)[i];
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_SORTEDINDEX_HPP
@@ -0,0 +1,473 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_SORTING_HPP
+#define EX4_SORTING_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include "ThreadPool.hpp"
+#include "SimdSupport.hpp"
+
+namespace genericContainer {
+
+    // How sort indices are built (see MyContainer::setLazySort / setParallelSort)
+    struct SortOptions {
+        bool lazy = false;                   // Settle positions only when they are read
+        bool permute = false;                // Sort positions into the storage instead of copies
+        size_t parallelThreshold = 1 << 20;  // Sort in parallel from this many elements
+        unsigned threads = 0;                // Parallel sort tasks (0 = one per hardware thread)
+        size_t memoryLimit = 0;              // Bytes a sort may hold in RAM before spilling (0 = no limit)
+        std::string spillDirectory;          // Where spilled runs go ("" = $TMPDIR, else /tmp)
+    };
+
+    namespace sorting {
+
+        // Below this many elements std::sort beats a radix sort's histogram passes
+        constexpr size_t radixThreshold = 256;
+
+        // Up to this many arithmetic keys are sorted by a sorting network
+        constexpr size_t networkThreshold = 64;
+
+        // Unsigned integer of the same width as Key
+        template<size_t Bytes> struct UnsignedOfSize;
+        template<> struct UnsignedOfSize<1> { using type = uint8_t; };
+        template<> struct UnsignedOfSize<2> { using type = uint16_t; };
+        template<> struct UnsignedOfSize<4> { using type = uint32_t; };
+        template<> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+        // True when keys sorted by less can be radix sorted instead: arithmetic keys in
+        // natural order (long double and wider types keep std::sort)
+        template<typename Key, typename Less>
+        struct UsesRadix
+                : std::integral_constant<bool,
+                        std::is_arithmetic<Key>::value &&
+                        (std::is_same<Less, std::less<Key>>::value || std::is_same<Less, std::less<>>::value) &&
+                        (std::is_integral<Key>::value ? sizeof(Key) <= 8 : (sizeof(Key) == 4 || sizeof(Key) == 8))> {};
+
+        // Maps a key to an unsigned integer with the same ordering:
+        // signed integers get their sign bit flipped; floating point values flip the
+        // sign bit when positive and every bit when negative
+        template<typename Key>
+        typename UnsignedOfSize<sizeof(Key)>::type radixKey(Key key) {
+            using Bits = typename UnsignedOfSize<sizeof(Key)>::type;
+            constexpr Bits signBit = Bits(1) << (sizeof(Key) * 8 - 1);
+            Bits bits;
+            std::memcpy(&bits, &key, sizeof(Key));
+            if constexpr (std::is_floating_point<Key>::value) {
+                return (bits & signBit) ? Bits(~bits) : Bits(bits | signBit);
+            } else if constexpr (std::is_signed<Key>::value) {
+                return bits ^ signBit;
+            } else {
+                return bits;
+            }
+        }
+
+        // Counting sort for one-byte keys (char, bool, int8_t): one counting pass,
+        // then the keys are rewritten in order – no scratch buffer
+        template<typename Key>
+        void countingSort(Key* keys, size_t n) {
+            size_t counts[256] = {};
+            for (size_t i = 0; i < n; ++i) {
+                ++counts[radixKey(keys[i])];
+            }
+            Key* out = keys;
+            for (unsigned byte = 0; byte < 256; ++byte) {
+                if (counts[byte] == 0) {
+                    continue;
+                }
+                // Recover the key from its byte (the mapping is a bijection)
+                Key key;
+                uint8_t raw = static_cast<uint8_t>(byte);
+                if constexpr (std::is_signed<Key>::value) {
+                    raw ^= 0x80;
+                }
+                std::memcpy(&key, &raw, 1);
+                out = std::fill_n(out, counts[byte], key);
+            }
+        }
+
+        // LSD radix sort, 8 bits per pass. All histograms are built in one read pass
+        // and passes where every key has the same byte are skipped.
+        template<typename Key>
+        void radixSort(Key* keys, size_t n, Key* scratch) {
+            constexpr size_t passes = sizeof(Key);
+            std::vector<size_t> counts(passes * 256, 0);
+            for (size_t i = 0; i < n; ++i) {
+                auto bits = radixKey(keys[i]);
+                for (size_t pass = 0; pass < passes; ++pass) {
+                    ++counts[pass * 256 + ((bits >> (pass * 8)) & 0xFF)];
+                }
+            }
+
+            Key* source = keys;
+            Key* target = scratch;
+            for (size_t pass = 0; pass < passes; ++pass) {
+                size_t* count = &counts[pass * 256];
+                if (std::find(count, count + 256, n) != count + 256) {
+                    continue;  // every key has the same byte here
+                }
+                size_t offset = 0;
+                for (size_t byte = 0; byte < 256; ++byte) {
+                    size_t c = count[byte];
+                    count[byte] = offset;
+                    offset += c;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    target[count[(radixKey(source[i]) >> (pass * 8)) & 0xFF]++] = source[i];
+                }
+                std::swap(source, target);
+            }
+            if (source != keys) {
+                std::copy(source, source + n, keys);
+            }
+        }
+
+        // Branchless compare-exchange: leaves min(a, b) in a and max(a, b) in b
+        template<typename Key>
+        inline void compareExchange(Key& a, Key& b) {
+            bool swapped = b < a;
+            Key lo = swapped ? b : a;
+            Key hi = swapped ? a : b;
+            a = lo;
+            b = hi;
+        }
+
+        // Bitonic sorting network over exactly Size keys (a power of two). Every stage
+        // compares fixed pairs with no data-dependent branches, and the inner loops run
+        // over contiguous lanes so the compiler turns them into SIMD min/max.
+        template<size_t Size, typename Key>
+        void bitonicSort(Key* keys) {
+            for (size_t k = 2; k <= Size; k *= 2) {
+                // Merge sorted halves of each k-block: the first step compares mirrored pairs
+                for (size_t block = 0; block < Size; block += k) {
+                    for (size_t i = 0; i < k / 2; ++i) {
+                        compareExchange(keys[block + i], keys[block + k - 1 - i]);
+                    }
+                }
+                for (size_t j = k / 4; j > 0; j /= 2) {
+                    for (size_t block = 0; block < Size; block += 2 * j) {
+                        for (size_t i = 0; i < j; ++i) {
+                            compareExchange(keys[block + i], keys[block + i + j]);
+                        }
+                    }
+                }
+            }
+        }
+
+#ifdef MYCONTAINER_SIMD_X86
+
+        // 32-bit keys the AVX2 network handles
+        template<typename Key>
+        struct AvxNetworkKey
+                : std::integral_constant<bool,
+                        sizeof(Key) == 4 && (std::is_same<Key, float>::value ||
+                                             (std::is_integral<Key>::value && !std::is_same<Key, bool>::value))> {};
+
+        // Lane-wise min(a, b) / max(a, b); on ties both return b, so a compare-exchange
+        // that passes its own lane as b never duplicates a key (matters for -0.0 / +0.0)
+        template<typename Key>
+        __attribute__((target("avx2")))
+        inline __m256i minLanes(__m256i a, __m256i b) {
+            if constexpr (std::is_same<Key, float>::value) {
+                return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+            } else if constexpr (std::is_signed<Key>::value) {
+                return _mm256_min_epi32(a, b);
+            } else {
+                return _mm256_min_epu32(a, b);
+            }
+        }
+
+        template<typename Key>
+        __attribute__((target("avx2")))
+        inline __m256i maxLanes(__m256i a, __m256i b) {
+            if constexpr (std::is_same<Key, float>::value) {
+                return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+            } else if constexpr (std::is_signed<Key>::value) {
+                return _mm256_max_epi32(a, b);
+            } else {
+                return _mm256_max_epu32(a, b);
+            }
+        }
+
+        // Blend masks for bitonicSortAvx2: lane l of register r in step s is all ones when
+        // key l * Vectors + r keeps the smaller key of its pair – the lower index of the
+        // pair in ascending runs ((index & k) == 0), the higher one otherwise
+        template<size_t Vectors>
+        struct NetworkMasks {
+            static constexpr size_t size = 8 * Vectors;
+            static constexpr size_t steps = [] {
+                size_t count = 0;
+                for (size_t k = 2; k <= size; k *= 2) {
+                    for (size_t j = k / 2; j > 0; j /= 2) {
+                        ++count;
+                    }
+                }
+                return count;
+            }();
+            alignas(32) uint32_t rows[steps][Vectors][8] = {};
+
+            constexpr NetworkMasks() {
+                size_t step = 0;
+                for (size_t k = 2; k <= size; k *= 2) {
+                    for (size_t j = k / 2; j > 0; j /= 2, ++step) {
+                        for (size_t r = 0; r < Vectors; ++r) {
+                            for (size_t lane = 0; lane < 8; ++lane) {
+                                size_t index = lane * Vectors + r;
+                                bool keepsMin = ((index & j) == 0) == ((index & k) == 0);
+                                rows[step][r][lane] = keepsMin ? ~uint32_t(0) : 0;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        template<size_t Vectors>
+        inline constexpr NetworkMasks<Vectors> networkMasks{};
+
+        // Bitonic network over 8 * Vectors 32-bit keys held in AVX2 registers.
+        // Keys are transposed (key i lives in lane i / Vectors of register i % Vectors),
+        // so short compare distances pair whole registers and only the long ones need
+        // a lane permute. Each step takes min and max for every register and blends
+        // them with a precomputed mask.
+        template<size_t Vectors, typename Key>
+        __attribute__((target("avx2")))
+        void bitonicSortAvx2(Key* keys) {
+            constexpr size_t Size = 8 * Vectors;
+            const auto& masks = networkMasks<Vectors>;
+            alignas(32) Key lanes[Size];
+            #pragma GCC unroll 64
+            for (size_t i = 0; i < Size; ++i) {
+                lanes[(i % Vectors) * 8 + i / Vectors] = keys[i];
+            }
+            __m256i reg[Vectors];
+            #pragma GCC unroll 64
+            for (size_t r = 0; r < Vectors; ++r) {
+                reg[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes + r * 8));
+            }
+
+            // Fully unrolled, so reg[] stays in registers and every index is a constant
+            const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            size_t step = 0;
+            #pragma GCC unroll 64
+            for (size_t k = 2; k <= Size; k *= 2) {
+                #pragma GCC unroll 64
+                for (size_t j = k / 2; j > 0; j /= 2, ++step) {
+                    __m256i next[Vectors];
+                    #pragma GCC unroll 64
+                    for (size_t r = 0; r < Vectors; ++r) {
+                        __m256i partner = j < Vectors
+                                ? reg[r ^ j]
+                                : _mm256_permutevar8x32_epi32(
+                                        reg[r], _mm256_xor_si256(laneIndex, _mm256_set1_epi32(int(j / Vectors))));
+                        __m256i keepsMin = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.rows[step][r]));
+                        next[r] = _mm256_blendv_epi8(maxLanes<Key>(partner, reg[r]), minLanes<Key>(partner, reg[r]),
+                                                     keepsMin);
+                    }
+                    #pragma GCC unroll 64
+                    for (size_t r = 0; r < Vectors; ++r) {
+                        reg[r] = next[r];
+                    }
+                }
+            }
+
+            #pragma GCC unroll 64
+            for (size_t r = 0; r < Vectors; ++r) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + r * 8), reg[r]);
+            }
+            #pragma GCC unroll 64
+            for (size_t i = 0; i < Size; ++i) {
+                keys[i] = lanes[(i % Vectors) * 8 + i / Vectors];
+            }
+        }
+
+#endif // MYCONTAINER_SIMD_X86
+
+        // Pads n keys with the largest key value to Size, runs the network and copies
+        // the first n back. Returns false (keys untouched) when a NaN is present, since
+        // padding could then displace real keys.
+        template<size_t Size, typename Key>
+        bool networkSortPadded(Key* first, size_t n) {
+            Key buffer[Size];
+            bool hasNan = false;
+            for (size_t i = 0; i < n; ++i) {
+                buffer[i] = first[i];
+                hasNan |= !(first[i] == first[i]);
+            }
+            if (hasNan) {
+                return false;
+            }
+            Key padding = std::numeric_limits<Key>::has_infinity ? std::numeric_limits<Key>::infinity()
+                                                                 : std::numeric_limits<Key>::max();
+            for (size_t i = n; i < Size; ++i) {
+                buffer[i] = padding;
+            }
+#ifdef MYCONTAINER_SIMD_X86
+            if constexpr (AvxNetworkKey<Key>::value) {
+                if (cpuHasAvx2()) {
+                    bitonicSortAvx2<Size / 8>(buffer);
+                    std::copy(buffer, buffer + n, first);
+                    return true;
+                }
+            }
+#endif
+            bitonicSort<Size>(buffer);
+            std::copy(buffer, buffer + n, first);
+            return true;
+        }
+
+        // Sorting network for up to networkThreshold arithmetic keys, padded to the next
+        // network size (8, 16, 32 or 64). Returns false if the keys must be sorted otherwise.
+        template<typename Key>
+        bool networkSort(Key* first, size_t n) {
+            static_assert(networkThreshold == 64, "network sizes below cover up to 64 keys");
+            if (n <= 8) {
+                return networkSortPadded<8>(first, n);
+            }
+            if (n <= 16) {
+                return networkSortPadded<16>(first, n);
+            }
+            if (n <= 32) {
+                return networkSortPadded<32>(first, n);
+            }
+            return networkSortPadded<64>(first, n);
+        }
+
+        // Sorts [first, first + n) on the calling thread: a sorting network for small
+        // arrays and radix or counting sort for larger ones when keys are arithmetic
+        // in natural order, std::sort otherwise
+        template<typename Key, typename Less>
+        void sortRange(Key* first, size_t n, Less less) {
+            if constexpr (UsesRadix<Key, Less>::value) {
+                if (n <= 1) {
+                    return;
+                }
+                if (n <= networkThreshold && networkSort(first, n)) {
+                    return;
+                }
+                if constexpr (sizeof(Key) == 1) {
+                    countingSort(first, n);
+                    return;
+                }
+                if (n >= radixThreshold) {
+                    std::vector<Key> scratch(n);
+                    radixSort(first, n, scratch.data());
+                    return;
+                }
+            }
+            std::sort(first, first + n, less);
+        }
+
+        // Number of elements of a that precede output position d when merging a and b
+        // (ties taken from a first, so the merge is stable)
+        template<typename Key, typename Less>
+        size_t coRank(size_t d, const Key* a, size_t aSize, const Key* b, size_t bSize, Less less) {
+            size_t lo = d > bSize ? d - bSize : 0;
+            size_t hi = std::min(d, aSize);
+            while (lo < hi) {
+                size_t i = lo + (hi - lo) / 2;
+                size_t j = d - i;
+                if (j > 0 && !less(b[j - 1], a[i])) {
+                    lo = i + 1;
+                } else {
+                    hi = i;
+                }
+            }
+            return lo;
+        }
+
+        // Parallel merge sort: sorts one chunk per task, then merges neighbouring runs
+        // round by round. Each merge is split into independent pieces by co-ranking,
+        // so the last rounds stay parallel too.
+        template<typename Key, typename Less>
+        void parallelSort(std::vector<Key>& keys, Less less, unsigned tasks, ThreadPool& pool) {
+            size_t n = keys.size();
+            std::vector<size_t> runs;  // Run boundaries
+            for (unsigned t = 0; t <= tasks; ++t) {
+                runs.push_back(n * t / tasks);
+            }
+
+            std::vector<std::function<void()>> jobs;
+            for (size_t r = 0; r + 1 < runs.size(); ++r) {
+                size_t first = runs[r];
+                size_t last = runs[r + 1];
+                jobs.emplace_back([&keys, first, last, less] {
+                    sortRange(keys.data() + first, last - first, less);
+                });
+            }
+            pool.runAll(jobs);
+
+            std::vector<Key> buffer(n);
+            std::vector<Key>* source = &keys;
+            std::vector<Key>* target = &buffer;
+            while (runs.size() > 2) {
+                jobs.clear();
+                std::vector<size_t> merged;
+                size_t pairs = (runs.size() - 1) / 2;
+                size_t pieces = std::max<size_t>(1, tasks / std::max<size_t>(1, pairs));
+
+                for (size_t r = 0; r + 1 < runs.size(); r += 2) {
+                    merged.push_back(runs[r]);
+                    const Key* a = source->data() + runs[r];
+                    Key* out = target->data() + runs[r];
+                    if (r + 2 >= runs.size()) {
+                        size_t count = runs[r + 1] - runs[r];
+                        jobs.emplace_back([a, out, count] { std::copy(a, a + count, out); });
+                        continue;
+                    }
+                    size_t aSize = runs[r + 1] - runs[r];
+                    const Key* b = source->data() + runs[r + 1];
+                    size_t bSize = runs[r + 2] - runs[r + 1];
+                    for (size_t p = 0; p < pieces; ++p) {
+                        size_t d0 = (aSize + bSize) * p / pieces;
+                        size_t d1 = (aSize + bSize) * (p + 1) / pieces;
+                        jobs.emplace_back([=] {
+                            size_t i0 = coRank(d0, a, aSize, b, bSize, less);
+                            size_t i1 = coRank(d1, a, aSize, b, bSize, less);
+                            std::merge(a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), out + d0, less);
+                        });
+                    }
+                }
+                merged.push_back(n);
+                pool.runAll(jobs);
+                std::swap(source, target);
+                runs.swap(merged);
+            }
+            if (source != &keys) {
+                keys.swap(buffer);
+            }
+        }
+
+    } // namespace sorting
+
+    // Sorts keys with less, in parallel on the shared pool when the options allow it.
+    // Arithmetic keys in natural order are radix sorted (counting sort for one-byte keys).
+    template<typename Key, typename Less>
+    void sortKeys(std::vector<Key>& keys, Less less, const SortOptions& options = SortOptions()) {
+        if constexpr (std::is_same<Key, bool>::value) {
+            std::sort(keys.begin(), keys.end(), less);  // vector<bool> has no contiguous storage
+        } else {
+            if constexpr (std::is_default_constructible<Key>::value) {
+                // hardware_concurrency() reads /sys on Linux – keep it off the small-sort path
+                if (keys.size() >= options.parallelThreshold) {
+                    unsigned tasks = options.threads ? options.threads : std::thread::hardware_concurrency();
+                    if (tasks > 1 && keys.size() >= 2 * tasks) {
+                        sorting::parallelSort(keys, less, tasks, ThreadPool::shared());
+                        return;
+                    }
+                }
+            }
+            sorting::sortRange(keys.data(), keys.size(), less);
+        }
+    }
+
+} // namespace genericContainer
+
+#endif // EX4_SORTING_HPP
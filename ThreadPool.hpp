@@ -0,0 +1,154 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_THREADPOOL_HPP
+#define EX4_THREADPOOL_HPP
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+
+namespace genericContainer {
+
+    // Fixed-size pool of worker threads for fork-join work (e.g. parallel sorts)
+    class ThreadPool {
+    private:
+        // Tasks submitted together by one runAll call
+        struct Batch {
+            std::mutex mutex;
+            std::condition_variable done;
+            size_t remaining = 0;
+            std::exception_ptr error;  // First exception thrown by a task
+        };
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+
+        // Pops one queued task; returns false if the queue is empty
+        bool tryRunOne() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (tasks.empty()) {
+                    return false;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+
+        // Worker loop – runs tasks until the pool is destroyed
+        void work() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (stopping && tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        // Constructor – starts the given number of workers (at least one)
+        explicit ThreadPool(unsigned threads) {
+            if (threads == 0) {
+                threads = 1;
+            }
+            for (unsigned i = 0; i < threads; ++i) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Destructor – finishes queued tasks and joins the workers
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        // Number of worker threads
+        size_t size() const {
+            return workers.size();
+        }
+
+        // Runs every job and waits for all of them. The calling thread helps with
+        // queued work while it waits, so nested calls cannot deadlock.
+        // Rethrows the first exception thrown by a job.
+        void runAll(std::vector<std::function<void()>>& jobs) {
+            if (jobs.empty()) {
+                return;
+            }
+            auto batch = std::make_shared<Batch>();
+            batch->remaining = jobs.size();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& job : jobs) {
+                    tasks.emplace_back([batch, job = std::move(job)] {
+                        try {
+                            job();
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(batch->mutex);
+                            if (!batch->error) {
+                                batch->error = std::current_exception();
+                            }
+                        }
+                        std::lock_guard<std::mutex> lock(batch->mutex);
+                        if (--batch->remaining == 0) {
+                            batch->done.notify_all();
+                        }
+                    });
+                }
+            }
+            wake.notify_all();
+
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(batch->mutex);
+                    if (batch->remaining == 0) {
+                        break;
+                    }
+                }
+                if (!tryRunOne()) {
+                    std::unique_lock<std::mutex> lock(batch->mutex);
+                    batch->done.wait(lock, [&batch] { return batch->remaining == 0; });
+                    break;
+                }
+            }
+            if (batch->error) {
+                std::rethrow_exception(batch->error);
+            }
+        }
+
+        // Process-wide pool with one worker per hardware thread
+        static ThreadPool& shared() {
+            static ThreadPool pool(std::thread::hardware_concurrency());
+            return pool;
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_THREADPOOL_HPP
@@ -0,0 +1,215 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_TOMBSTONESTORAGE_HPP
+#define EX4_TOMBSTONESTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "SortedIndex.hpp"
+#include "MembershipIndex.hpp"
+
+namespace genericContainer {
+
+    // MyContainer storage policy for remove-heavy workloads (T needs std::hash).
+    // remove(value) looks the value's slots up in a hash index and only marks them dead
+    // in a bitmap – O(k) for k matches, nothing moves. Views and output skip dead slots.
+    // Once more than DeadPercent of the slots are dead, one O(n) pass compacts them all,
+    // so the cost of moving elements is shared by a whole batch of removals.
+    template<typename T, size_t DeadPercent = 25>
+    class TombstoneStorage {
+    private:
+        static_assert(Hashable<T>::value, "TombstoneStorage indexes slots by value and needs std::hash<T>");
+        static_assert(DeadPercent > 0 && DeadPercent < 100, "DeadPercent must be between 1 and 99");
+
+        std::vector<T> slots;                       // Live and dead elements in insertion order
+        std::vector<uint64_t> dead;                 // Bit i set = slot i removed
+        size_t deadCount = 0;
+        std::unordered_multimap<T, size_t> index;  // Live slots by value
+
+        bool isDead(size_t i) const {
+            return (dead[i / 64] >> (i % 64)) & 1;
+        }
+
+        void bury(size_t i) {
+            dead[i / 64] |= uint64_t(1) << (i % 64);
+            ++deadCount;
+        }
+
+        template<typename... Args>
+        void append(Args&&... args) {
+            slots.emplace_back(std::forward<Args>(args)...);
+            try {
+                if (slots.size() > dead.size() * 64) {
+                    dead.push_back(0);
+                }
+                index.emplace(slots.back(), slots.size() - 1);
+            } catch (...) {
+                slots.pop_back();
+                throw;
+            }
+        }
+
+        // Marks every live slot holding value dead; returns how many
+        size_t buryValue(const T& value) {
+            auto range = index.equal_range(value);
+            size_t removed = 0;
+            for (auto it = range.first; it != range.second; ++it) {
+                bury(it->second);
+                ++removed;
+            }
+            index.erase(range.first, range.second);
+            return removed;
+        }
+
+        // Compacts once the dead slots pass the threshold; returns true if it did
+        bool collect() {
+            if (deadCount * 100 > slots.size() * DeadPercent) {
+                compact();
+                return true;
+            }
+            return false;
+        }
+
+        // Rebuilds the index from the live slots – O(n)
+        void reindex() {
+            index.clear();
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (!isDead(i)) {
+                    index.emplace(slots[i], i);
+                }
+            }
+        }
+
+        // Moves the live elements together and re-indexes them – O(n)
+        void compact() {
+            size_t kept = 0;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (!isDead(i)) {
+                    if (kept != i) {
+                        slots[kept] = std::move(slots[i]);
+                    }
+                    ++kept;
+                }
+            }
+            slots.erase(slots.begin() + static_cast<std::ptrdiff_t>(kept), slots.end());
+            dead.assign((kept + 63) / 64, 0);
+            deadCount = 0;
+            reindex();
+        }
+
+    public:
+        // Borrowing views get an owning copy of the live elements
+        static constexpr bool contiguous = false;
+
+        // sortIndex may sort (and spill under a memory limit)
+        static constexpr bool presorted = false;
+
+        // What items() returns
+        using Items = std::vector<T>;
+
+        TombstoneStorage() = default;
+
+        // Constructor – copies the range [first, last)
+        template<typename InputIt>
+        TombstoneStorage(InputIt first, InputIt last) {
+            addRange(first, last);
+        }
+
+        void add(const T& item) {
+            append(item);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            append(std::forward<Args>(args)...);
+        }
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                append(*first);
+            }
+        }
+
+        void reserve(size_t capacity) {
+            slots.reserve(capacity);
+            dead.reserve((capacity + 63) / 64);
+            index.reserve(capacity);
+        }
+
+        // Live elements
+        size_t size() const {
+            return slots.size() - deadCount;
+        }
+
+        // O(n) scan that only marks matches dead, then one index rebuild (finding each
+        // match's own entry would cost O(duplicates) per match); pred runs once per live element
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
+            size_t removed = 0;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (!isDead(i) && pred(static_cast<const T&>(slots[i]))) {
+                    bury(i);
+                    ++removed;
+                }
+            }
+            if (removed > 0 && !collect()) {
+                reindex();
+            }
+            return removed;
+        }
+
+        // O(k) for k matches, plus an occasional compaction
+        size_t removeValue(const T& item) {
+            size_t removed = buryValue(item);
+            collect();
+            return removed;
+        }
+
+        // O(m + k) for m values with k matches
+        size_t removeValues(const std::vector<T>& sortedValues) {
+            size_t removed = 0;
+            for (const T& value : sortedValues) {
+                removed += buryValue(value);
+            }
+            collect();
+            return removed;
+        }
+
+        // Live elements in insertion order (a copy)
+        std::vector<T> items() const {
+            std::vector<T> result;
+            result.reserve(size());
+            forEach([&result](const T& item) { result.push_back(item); });
+            return result;
+        }
+
+        // Calls f on every live element in insertion order; words with no dead slot
+        // are walked without testing bits
+        template<typename Function>
+        void forEach(Function f) const {
+            for (size_t word = 0; word * 64 < slots.size(); ++word) {
+                size_t first = word * 64;
+                size_t last = std::min(first + 64, slots.size());
+                uint64_t bits = dead[word];
+                for (size_t i = first; i < last; ++i) {
+                    if (bits == 0 || !((bits >> (i - first)) & 1)) {
+                        f(slots[i]);
+                    }
+                }
+            }
+        }
+
+        // Sorts a copy of the live values
+        std::shared_ptr<const SortedIndex<T>> sortIndex(const size_t*, const SortOptions& options) const {
+            return std::make_shared<const SortedIndex<T>>(SortedIndex<T>::byValue(items(), options));
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_TOMBSTONESTORAGE_HPP
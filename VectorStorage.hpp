@@ -0,0 +1,115 @@
+// roynaor10@gmail.com
+
+#ifndef EX4_VECTORSTORAGE_HPP
+#define EX4_VECTORSTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include "SortedIndex.hpp"
+#include "Compaction.hpp"
+
+namespace genericContainer {
+
+    // Default MyContainer storage policy: one contiguous vector in insertion order.
+    // add is amortized O(1); remove and the first sorted view after a change are O(n) / O(n log n).
+    // Alloc allocates the elements, e.g. std::pmr::polymorphic_allocator<T>.
+    template<typename T, typename Alloc = std::allocator<T>>
+    class VectorStorage {
+    private:
+        std::vector<T, Alloc> data;  // Elements in insertion order
+
+    public:
+        // Borrowing views can iterate data in place
+        static constexpr bool contiguous = true;
+
+        // sortIndex may sort (and spill under a memory limit)
+        static constexpr bool presorted = false;
+
+        // What items() refers to
+        using Items = std::vector<T, Alloc>;
+        using allocator_type = Alloc;
+
+        VectorStorage() = default;
+
+        explicit VectorStorage(const Alloc& alloc)
+                : data(alloc) {}
+
+        // Constructor – copies the range [first, last)
+        template<typename InputIt>
+        VectorStorage(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+                : data(first, last, alloc) {}
+
+        void add(const T& item) {
+            data.push_back(item);
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            data.emplace_back(std::forward<Args>(args)...);
+        }
+
+        template<typename InputIt>
+        void addRange(InputIt first, InputIt last) {
+            data.insert(data.end(), first, last);
+        }
+
+        void reserve(size_t capacity) {
+            data.reserve(capacity);
+        }
+
+        size_t size() const {
+            return data.size();
+        }
+
+        // Compacts in place in a single pass; returns the number removed
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
+            auto newEnd = std::remove_if(data.begin(), data.end(), pred);
+            size_t removed = static_cast<size_t>(data.end() - newEnd);
+            data.erase(newEnd, data.end());
+            return removed;
+        }
+
+        // Removes every element equal to item (SIMD compaction for arithmetic T)
+        size_t removeValue(const T& item) {
+            size_t removed = removeEqual(data.data(), data.size(), item);
+            data.erase(data.end() - static_cast<std::ptrdiff_t>(removed), data.end());
+            return removed;
+        }
+
+        // Removes every element equal to one of sortedValues (sorted, distinct)
+        size_t removeValues(const std::vector<T>& sortedValues) {
+            return removeIf([&sortedValues](const T& val) {
+                return std::binary_search(sortedValues.begin(), sortedValues.end(), val);
+            });
+        }
+
+        // Elements in insertion order
+        const std::vector<T, Alloc>& items() const {
+            return data;
+        }
+
+        // Calls f on every element in insertion order
+        template<typename Function>
+        void forEach(Function f) const {
+            for (const T& item : data) {
+                f(item);
+            }
+        }
+
+        // Sorts the elements into a new index (a permutation if requested)
+        std::shared_ptr<const SortedIndex<T>> sortIndex(const size_t* generation, const SortOptions& options) const {
+            if (SortedIndex<T>::permutes(options)) {
+                return std::make_shared<const SortedIndex<T>>(
+                        SortedIndex<T>::byPermutation(data, generation, options));
+            }
+            return std::make_shared<const SortedIndex<T>>(
+                    SortedIndex<T>::byValue(std::vector<T>(data.begin(), data.end()), options));
+        }
+    };
+
+} // namespace genericContainer
+
+#endif // EX4_VECTORSTORAGE_HPP
@@ -0,0 +1,676 @@
+// roynaor10@gmail.com
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MyContainer.hpp"
+#include "ConcurrentContainer.hpp"
+#include "MappedContainer.hpp"
+
+using namespace genericContainer;
+
+// Runs fn once and returns the elapsed wall time in milliseconds
+template<typename Fn>
+double timeMs(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// Hands a result to an empty asm statement the optimizer must assume reads it, so the
+// work that produced it is not dropped
+template<typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Prints one result line: label, time and throughput
+void report(const std::string& label, double ms, size_t n) {
+    std::cout << std::left << std::setw(34) << label
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms"
+              << std::setw(10) << std::setprecision(3) << (n / ms / 1000.0) << " M/s" << std::endl;
+}
+
+// Compares the ways of filling a container with n ints
+void benchIngest(size_t n) {
+    std::vector<int> source(n);
+    std::iota(source.begin(), source.end(), 0);
+
+    std::cout << "Ingest of " << n << " ints" << std::endl;
+
+    report("add() one at a time", timeMs([&] {
+        MyContainer<int> c;
+        for (int v : source) c.add(v);
+        if (c.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+
+    report("reserve() + add()", timeMs([&] {
+        MyContainer<int> c;
+        c.reserve(n);
+        for (int v : source) c.add(v);
+        if (c.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+
+    report("reserve() + emplace()", timeMs([&] {
+        MyContainer<int> c;
+        c.reserve(n);
+        for (int v : source) c.emplace(v);
+        if (c.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+
+    report("addRange()", timeMs([&] {
+        MyContainer<int> c;
+        c.addRange(source.begin(), source.end());
+        if (c.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+
+    report("range constructor", timeMs([&] {
+        MyContainer<int> c(source.data(), source.size());
+        if (c.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+}
+
+// Compares sorting copies of std::string against sorting a permutation of positions
+void benchSortIndex(size_t n) {
+    std::vector<std::string> words(n);
+    unsigned seed = 12345;
+    for (auto& w : words) {
+        seed = seed * 1103515245u + 12345u;
+        w = "key-" + std::to_string(seed) + "-padding-to-defeat-sso";
+    }
+
+    std::cout << "Sort index of " << n << " strings" << std::endl;
+
+    report("by value (copies T)", timeMs([&] {
+        auto index = SortedIndex<std::string>::byValue(words);
+        if (index.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+
+    report("by permutation", timeMs([&] {
+        auto index = SortedIndex<std::string>::byPermutation(words);
+        if (index.size() != n) std::cerr << "size mismatch" << std::endl;
+    }), n);
+}
+
+// Interleaves add, remove and a sorted view, as in a live ranking workload
+template<typename Storage>
+double interleaved(size_t n) {
+    return timeMs([&] {
+        MyContainer<int, Storage> c;
+        unsigned seed = 12345;
+        for (size_t i = 0; i < n; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            c.add(static_cast<int>(seed % 100000));
+            if (i % 4 == 3) {
+                c.removeAll(static_cast<int>(seed % 100000));
+            }
+            if (i % 64 == 0) {
+                auto asc = c.ascendingOrder();
+                if (asc.begin() == asc.end() && c.size() > 0) std::cerr << "empty view" << std::endl;
+            }
+        }
+    });
+}
+
+// Compares the vector storage against the always-sorted storage
+void benchStoragePolicies(size_t n) {
+    std::cout << "Interleaved add/remove/ascendingOrder, " << n << " ops" << std::endl;
+    report("VectorStorage", interleaved<VectorStorage<int>>(n), n);
+    report("OrderedStorage", interleaved<OrderedStorage<int>>(n), n);
+}
+
+// Reads the first k elements of a fresh ascending view, eager vs lazy sort
+void benchTopK(size_t n, size_t k) {
+    std::vector<int> source(n);
+    unsigned seed = 12345;
+    for (auto& v : source) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<int>(seed >> 1);
+    }
+
+    std::cout << "First " << k << " of " << n << " ints in ascending order" << std::endl;
+    for (bool lazy : {false, true}) {
+        MyContainer<int> c(source.begin(), source.end());
+        c.setLazySort(lazy);
+        report(lazy ? "lazy sort index" : "full sort index", timeMs([&] {
+            auto asc = c.ascendingOrder();
+            long long sum = 0;
+            auto it = asc.begin();
+            for (size_t i = 0; i < k; ++i, ++it) sum += *it;
+            doNotOptimize(sum);
+        }), n);
+    }
+}
+
+// Sums every element of a view – measures pure traversal cost
+template<typename View>
+long long sumView(const View& view) {
+    long long sum = 0;
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        sum += *it;
+    }
+    return sum;
+}
+
+// Full traversal with checked vs unchecked iterators
+void benchIteratorChecks(size_t n) {
+    std::vector<int> source(n);
+    std::iota(source.begin(), source.end(), 0);
+    MyContainer<int> c(source.begin(), source.end());
+    auto ascChecked = c.ascendingOrder<CheckedIterators>();
+    auto ascUnchecked = c.ascendingOrder<UncheckedIterators>();
+    auto orderChecked = c.orderView<CheckedIterators>();
+    auto orderUnchecked = c.orderView<UncheckedIterators>();
+    long long sink = 0;
+
+    std::cout << "Traversal of " << n << " ints" << std::endl;
+    report("ascending, checked", timeMs([&] { sink += sumView(ascChecked); }), n);
+    report("ascending, unchecked", timeMs([&] { sink += sumView(ascUnchecked); }), n);
+    report("orderView, checked", timeMs([&] { sink += sumView(orderChecked); }), n);
+    report("orderView, unchecked", timeMs([&] { sink += sumView(orderUnchecked); }), n);
+    doNotOptimize(sink);
+}
+
+// Sorted-view construction with 1..16 parallel sort tasks
+void benchParallelSort(size_t n) {
+    std::vector<int> source(n);
+    unsigned seed = 12345;
+    for (auto& v : source) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<int>(seed >> 1);
+    }
+    MyContainer<int> c(source.begin(), source.end());
+
+    std::cout << "ascendingOrder() of " << n << " ints, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        c.setParallelSort(1 << 16, threads);
+        c.add(0);  // invalidate the cached index
+        report(std::to_string(threads) + " sort task(s)", timeMs([&] {
+            auto asc = c.ascendingOrder();
+            if (*asc.begin() != 0) std::cerr << "unsorted" << std::endl;
+        }), n);
+    }
+}
+
+// Radix/counting sort against std::sort for one key type
+template<typename K>
+void benchRadixFor(const std::string& name, size_t n) {
+    std::vector<K> source(n);
+    unsigned seed = 12345;
+    for (auto& v : source) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<K>(static_cast<int>(seed >> 1) - (1 << 30));
+    }
+    std::vector<K> keys;
+
+    keys = source;
+    report(name + ", std::sort", timeMs([&] { std::sort(keys.begin(), keys.end()); }), n);
+    keys = source;
+    report(name + ", radix", timeMs([&] { sortKeys(keys, std::less<K>()); }), n);
+}
+
+// Sort-index key sorting for the radix-eligible types
+void benchRadix(size_t n) {
+    std::cout << "Sorting " << n << " keys" << std::endl;
+    benchRadixFor<int>("int", n);
+    benchRadixFor<double>("double", n);
+    benchRadixFor<char>("char", n);
+}
+
+// Purges one value (1 in 16 elements) with each compaction kernel
+template<typename K>
+void benchRemoveFor(const std::string& name, size_t n) {
+    std::vector<K> source(n);
+    for (size_t i = 0; i < n; ++i) source[i] = static_cast<K>(i % 16);
+    std::vector<K> work;
+    auto run = [&](const std::string& label, size_t (*kernel)(K*, size_t, const K&)) {
+        work = source;
+        size_t removed = 0;
+        double ms = timeMs([&] { removed = kernel(work.data(), work.size(), K(3)); });
+        if (removed != n / 16 + (n % 16 > 3)) std::cerr << "wrong count" << std::endl;
+        report(name + ", " + label, ms, n);
+    };
+
+    run("std::remove", &compaction::removeEqualScalar<K>);
+#ifdef MYCONTAINER_SIMD_X86
+    run("SSE2", &compaction::removeEqualSse2<K>);
+    if (cpuHasAvx2()) run("AVX2", &compaction::removeEqualAvx2<K>);
+#endif
+}
+
+// remove() on arithmetic element types
+void benchRemove(size_t n) {
+    std::cout << "Remove one value from " << n << " elements" << std::endl;
+    benchRemoveFor<int>("int", n);
+    benchRemoveFor<double>("double", n);
+}
+
+// Sorted views of tiny containers: views built per second, against copy + std::sort.
+// Inputs rotate through 1024 random arrays so branch predictors cannot learn one order.
+void benchSmallViews(size_t reps) {
+    std::cout << "Ascending views of small int containers, " << reps << " views each (M/s = million views/s)"
+              << std::endl;
+    constexpr size_t inputs = 1024;
+    for (size_t size : {8, 16, 32, 64}) {
+        std::vector<std::vector<int>> sources(inputs, std::vector<int>(size));
+        unsigned seed = 12345;
+        for (auto& source : sources) {
+            for (auto& v : source) {
+                seed = seed * 1103515245u + 12345u;
+                v = static_cast<int>(seed >> 1);
+            }
+        }
+        long long sink = 0;
+
+        report(std::to_string(size) + " ints, std::sort", timeMs([&] {
+            for (size_t r = 0; r < reps; ++r) {
+                std::vector<int> copy(sources[r % inputs]);
+                std::sort(copy.begin(), copy.end());
+                sink += copy[r % size];
+            }
+        }), reps);
+        report(std::to_string(size) + " ints, ascendingOrder", timeMs([&] {
+            for (size_t r = 0; r < reps; ++r) {
+                AscendingOrder<int> asc(sources[r % inputs]);
+                sink += *(asc.begin() + static_cast<std::ptrdiff_t>(r % size));
+            }
+        }), reps);
+        doNotOptimize(sink);
+    }
+}
+
+// Runs writers threads that each call add(n / writers) times through addOne
+template<typename AddOne>
+double concurrentAdds(size_t n, unsigned writers, AddOne addOne) {
+    return timeMs([&] {
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w] {
+                for (size_t i = w; i < n; i += writers) addOne(static_cast<int>(i));
+            });
+        }
+        for (auto& t : threads) t.join();
+    });
+}
+
+// add() from many writer threads: one global mutex vs the sharded container
+void benchConcurrentAdd(size_t n) {
+    std::cout << "Concurrent add of " << n << " ints, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    for (unsigned writers : {1u, 2u, 4u, 8u}) {
+        MyContainer<int> locked;
+        std::mutex lock;
+        report(std::to_string(writers) + " writer(s), global mutex", concurrentAdds(n, writers, [&](int v) {
+            std::lock_guard<std::mutex> guard(lock);
+            locked.add(v);
+        }), n);
+
+        ConcurrentContainer<int> sharded;
+        report(std::to_string(writers) + " writer(s), sharded", concurrentAdds(n, writers, [&](int v) {
+            sharded.add(v);
+        }), n);
+        if (locked.size() != n || sharded.size() != n) std::cerr << "size mismatch" << std::endl;
+    }
+}
+
+// order() on a read-heavy container: cost of making views, of the first change after
+// one, and of a full traversal
+template<typename Storage>
+void benchSnapshotsFor(const std::string& name, size_t n, size_t views) {
+    std::vector<int> source(n);
+    std::iota(source.begin(), source.end(), 0);
+    MyContainer<int, Storage> c(source.begin(), source.end());
+    long long sink = 0;
+
+    report(name + ", order() x" + std::to_string(views), timeMs([&] {
+        for (size_t v = 0; v < views; ++v) {
+            auto view = c.order();
+            sink += *view.begin();
+        }
+    }), views);
+    auto held = c.order();
+    report(name + ", add() after a view", timeMs([&] { c.add(-1); }), 1);
+    report(name + ", traverse order()", timeMs([&] { sink += sumView(held); }), n);
+    doNotOptimize(sink);
+}
+
+void benchSnapshots(size_t n) {
+    std::cout << "Views of " << n << " ints (M/s = million views, adds or elements/s)" << std::endl;
+    benchSnapshotsFor<VectorStorage<int>>("vector", n, 10);
+    benchSnapshotsFor<ChunkedStorage<int>>("chunked", n, 10);
+}
+
+// Request loop that builds and drops owning views: global heap vs a reused pool
+void benchArenaViews(size_t reps, size_t size) {
+    std::vector<int> source(size);
+    std::iota(source.begin(), source.end(), 0);
+    MyContainer<int> c(source.begin(), source.end());
+    std::pmr::unsynchronized_pool_resource pool;
+    long long sink = 0;
+
+    std::cout << "order() + reverseOrder() on " << size << " ints, " << reps << " requests" << std::endl;
+    report("global heap", timeMs([&] {
+        for (size_t r = 0; r < reps; ++r) {
+            auto order = c.order();
+            auto reverse = c.reverseOrder();
+            sink += *order.begin() + *reverse.begin();
+        }
+    }), reps);
+    report("pool resource", timeMs([&] {
+        for (size_t r = 0; r < reps; ++r) {
+            auto order = c.order(&pool);
+            auto reverse = c.reverseOrder(&pool);
+            sink += *order.begin() + *reverse.begin();
+        }
+    }), reps);
+    doNotOptimize(sink);
+}
+
+// Stream buffer that counts and discards what is written
+class CountingBuffer : public std::streambuf {
+public:
+    size_t bytes = 0;
+
+protected:
+    int overflow(int ch) override {
+        ++bytes;
+        return ch;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        bytes += static_cast<size_t>(count);
+        return count;
+    }
+};
+
+// Dumping a container as "[ a b c ]": per-element stream output vs the buffered path
+template<typename T>
+void benchFormatFor(const std::string& name, size_t n) {
+    std::vector<T> source(n);
+    unsigned seed = 12345;
+    for (auto& v : source) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<T>(static_cast<int>(seed >> 1) - (1 << 30)) / static_cast<T>(64);
+    }
+    MyContainer<T> c(source.begin(), source.end());
+
+    CountingBuffer perElement;
+    std::ostream slow(&perElement);
+    double ms = timeMs([&] {
+        slow << "[ ";
+        for (const T& v : source) slow << v << " ";
+        slow << "]";
+    });
+    report(name + ", os << item per element", ms, perElement.bytes);
+
+    CountingBuffer buffered;
+    std::ostream fast(&buffered);
+    ms = timeMs([&] { fast << c; });
+    report(name + ", operator<<", ms, buffered.bytes);
+    if (buffered.bytes != perElement.bytes) std::cerr << "output differs" << std::endl;
+
+    int devNull = open("/dev/null", O_WRONLY);
+    report(name + ", writeFormatted(fd)", timeMs([&] { writeFormatted(devNull, c.orderView()); }),
+           buffered.bytes);
+    close(devNull);
+}
+
+void benchFormat(size_t n) {
+    std::cout << "Formatting " << n << " elements (M/s = MB/s)" << std::endl;
+    benchFormatFor<int>("int", n);
+    benchFormatFor<double>("double", n);
+}
+
+// Restart: rebuilding with add() vs loading a saved file vs mapping it, each followed by
+// the first ascendingOrder() (or one pass over the mapped file)
+void benchColdStart(size_t n) {
+    std::vector<int> source(n);
+    unsigned seed = 12345;
+    for (auto& v : source) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<int>(seed >> 1);
+    }
+    MyContainer<int> c(source.begin(), source.end());
+    const std::string plain = "/tmp/mycontainer-bench.bin";
+    const std::string indexed = "/tmp/mycontainer-bench-indexed.bin";
+    c.save(plain);
+    c.save(indexed, true);
+    long long sink = 0;
+
+    std::cout << "Cold start of " << n << " ints + first ascendingOrder()" << std::endl;
+    report("add() each element", timeMs([&] {
+        MyContainer<int> rebuilt;
+        for (int v : source) rebuilt.add(v);
+        sink += *rebuilt.ascendingOrder().begin();
+    }), n);
+    report("load()", timeMs([&] {
+        MyContainer<int> loaded;
+        loaded.load(plain);
+        sink += *loaded.ascendingOrder().begin();
+    }), n);
+    report("load() with permutation", timeMs([&] {
+        MyContainer<int> loaded;
+        loaded.load(indexed);
+        sink += *loaded.ascendingOrder().begin();
+    }), n);
+    report("MappedContainer, traverse order()", timeMs([&] {
+        MappedContainer<int> mapped(plain);
+        sink += sumView(mapped.order());
+    }), n);
+    report("MappedContainer with permutation", timeMs([&] {
+        MappedContainer<int> mapped(indexed);
+        sink += *mapped.ascendingOrder().begin();
+    }), n);
+    std::remove(plain.c_str());
+    std::remove(indexed.c_str());
+    doNotOptimize(sink);
+}
+
+// Runs fn in a child process; returns its wall time and sets peakMb to its peak RSS
+template<typename Fn>
+double timeInChild(Fn fn, double& peakMb) {
+    auto start = std::chrono::steady_clock::now();
+    pid_t child = fork();
+    if (child == 0) {
+        fn();
+        _exit(0);
+    }
+    int status = 0;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+    peakMb = usage.ru_maxrss / 1024.0;
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ascendingOrder() of n ints and a full traversal, in RAM vs within a memory limit
+void benchSpilledSort(size_t n) {
+    std::cout << "ascendingOrder() + traversal of " << n << " ints in a fresh process" << std::endl;
+    for (size_t limitMb : {0, 64, 16}) {
+        double peakMb = 0;
+        double ms = timeInChild([&] {
+            MyContainer<int> c;
+            c.reserve(n);
+            unsigned seed = 12345;
+            for (size_t i = 0; i < n; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                c.add(static_cast<int>(seed >> 1));
+            }
+            c.setSortMemoryLimit(limitMb << 20);
+            doNotOptimize(sumView(c.ascendingOrder()));
+        }, peakMb);
+        std::string label = limitMb ? "limit " + std::to_string(limitMb) + " MB" : "no limit";
+        report(label + ", peak RSS " + std::to_string(static_cast<int>(peakMb)) + " MB", ms, n);
+    }
+}
+
+// Latency of every add() while growing a container to n ints: a vector copies
+// everything at each capacity boundary, segmented chunks never move
+template<typename Storage>
+void benchAddLatencyFor(const std::string& name, size_t n) {
+    std::vector<double> latencies(n);
+    MyContainer<int, Storage> c;
+    double ms = timeMs([&] {
+        for (size_t i = 0; i < n; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            c.add(static_cast<int>(i));
+            latencies[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) { return latencies[static_cast<size_t>(q * static_cast<double>(n - 1))]; };
+    std::ostringstream tail;
+    tail << std::fixed << std::setprecision(1) << " p99 " << at(0.99) << " p99.99 " << at(0.9999) << " p99.999 " << at(0.99999)
+         << " max " << latencies.back() << " us";
+    report(name + ",", ms, n);
+    std::cout << "    " << tail.str() << std::endl;
+}
+
+void benchAddLatency(size_t n) {
+    std::cout << "add() latency while growing to " << n << " ints (no reserve)" << std::endl;
+    benchAddLatencyFor<VectorStorage<int>>("VectorStorage", n);
+    benchAddLatencyFor<ChunkedStorage<int>>("ChunkedStorage", n);
+    benchAddLatencyFor<SegmentedStorage<int>>("SegmentedStorage", n);
+}
+
+// contains() and remove() of absent values, with each membership index
+void benchMembership(size_t n, size_t lookups) {
+    std::cout << "contains()/remove() of " << lookups << " absent values in " << n << " ints" << std::endl;
+    for (Membership mode : {Membership::None, Membership::Exact, Membership::Filter}) {
+        std::string name = mode == Membership::None ? "no index" : mode == Membership::Exact ? "exact" : "filter";
+        MyContainer<int> c;
+        c.reserve(n);
+        double build = timeMs([&] {
+            c.setMembershipIndex(mode, n);
+            for (size_t i = 0; i < n; ++i) c.add(static_cast<int>(i * 2));
+        });
+        report(name + ", add()", build, n);
+
+        size_t found = 0;
+        report(name + ", contains()", timeMs([&] {
+            for (size_t i = 0; i < lookups; ++i) found += c.contains(static_cast<int>(i * 7918 + 1));
+        }), lookups);
+        report(name + ", remove() of absent", timeMs([&] {
+            for (size_t i = 0; i < lookups; ++i) {
+                try {
+                    c.remove(static_cast<int>(i * 7918 + 1));
+                } catch (const std::invalid_argument&) {
+                    ++found;
+                }
+            }
+        }), lookups);
+        if (found != lookups) std::cerr << "unexpected hits" << std::endl;
+    }
+}
+
+// remove() of many single values one call at a time, then a full traversal
+template<typename Storage>
+void benchRemoveBatchFor(const std::string& name, size_t n, size_t removals) {
+    MyContainer<int, Storage> c;
+    c.reserve(n);
+    for (size_t i = 0; i < n; ++i) c.add(static_cast<int>(i));
+    report(name + ", remove() x" + std::to_string(removals), timeMs([&] {
+        for (size_t i = 0; i < removals; ++i) {
+            c.remove(static_cast<int>((i * 7919) % n));
+        }
+    }), removals);
+    long long sink = 0;
+    report(name + ", traverse order()", timeMs([&] { sink += sumView(c.order()); }), c.size());
+    doNotOptimize(sink);
+}
+
+void benchRemoveBatch(size_t n, size_t removals) {
+    std::cout << "Removing " << removals << " distinct values from " << n << " ints" << std::endl;
+    benchRemoveBatchFor<VectorStorage<int>>("VectorStorage", n, removals);
+    benchRemoveBatchFor<TombstoneStorage<int>>("TombstoneStorage", n, removals);
+}
+
+// Even values doubled and summed: copying into vectors after each step vs one fused
+// adaptor pipeline; then the first 100 of them in ascending order from a lazy sort
+void benchAdaptors(size_t n) {
+    using namespace adaptors;
+    MyContainer<int> c;
+    c.reserve(n);
+    unsigned seed = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        c.add(static_cast<int>(seed >> 8));
+    }
+    auto even = [](int v) { return v % 2 == 0; };
+    auto twice = [](int v) { return static_cast<long long>(v) * 2; };
+    std::cout << "filter/transform/sum over " << n << " ints" << std::endl;
+
+    long long copied = 0;
+    report("copy into vectors", timeMs([&] {
+        std::vector<int> evens;
+        for (int v : c.orderView<UncheckedIterators>()) {
+            if (even(v)) evens.push_back(v);
+        }
+        std::vector<long long> doubled;
+        doubled.reserve(evens.size());
+        for (int v : evens) doubled.push_back(twice(v));
+        copied = std::accumulate(doubled.begin(), doubled.end(), 0LL);
+    }), n);
+
+    long long fused = 0;
+    report("adaptor pipeline", timeMs([&] {
+        auto pipeline = c.orderView<UncheckedIterators>() | filter(even) | transform(twice);
+        fused = std::accumulate(pipeline.begin(), pipeline.end(), 0LL);
+    }), n);
+    if (copied != fused) std::cerr << "sum mismatch" << std::endl;
+
+    report("first 100 ascending, copied", timeMs([&] {
+        std::vector<long long> firsts;
+        for (int v : c.ascendingOrder()) {
+            if (even(v)) firsts.push_back(twice(v));
+        }
+        firsts.resize(std::min<size_t>(firsts.size(), 100));
+        copied = std::accumulate(firsts.begin(), firsts.end(), 0LL);
+    }), n);
+    c.setLazySort(true);
+    report("first 100 ascending, lazy pipeline", timeMs([&] {
+        auto firsts = c.ascendingOrder() | filter(even) | take(100) | transform(twice);
+        fused = std::accumulate(firsts.begin(), firsts.end(), 0LL);
+    }), n);
+    if (copied != fused) std::cerr << "sum mismatch" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 10000000;
+
+    benchIngest(n);
+    benchSortIndex(n / 10);
+    benchStoragePolicies(n / 200);
+    benchTopK(n, 100);
+    benchIteratorChecks(n);
+    benchParallelSort(n);
+    benchRadix(n);
+    benchRemove(n);
+    benchSmallViews(n / 10);
+    benchConcurrentAdd(n);
+    benchSnapshots(n);
+    benchArenaViews(n / 10, 1000);
+    benchFormat(n);
+    benchColdStart(n);
+    benchSpilledSort(n);
+    benchAddLatency(n * 2);
+    benchMembership(n, 200);
+    benchRemoveBatch(n / 10, n / 1000);
+    benchAdaptors(n);
+
+    return 0;
+}
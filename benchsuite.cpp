@@ -0,0 +1,434 @@
+// roynaor10@gmail.com
+
+// Benchmark matrix: every operation x element type x size, with throughput and
+// p50/p99 latency per operation, written as text and optionally as JSON that a later
+// run can be compared against.
+//
+//   ./benchsuite [--sizes 1e3,1e4,...] [--types int,double,char,string]
+//                [--json out.json] [--baseline old.json] [--threshold 10] [--max-mb 4096]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "MyContainer.hpp"
+
+using namespace genericContainer;
+
+using Clock = std::chrono::steady_clock;
+
+// Nanoseconds between two clock readings
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point stop) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+}
+
+// Median cost of one clock reading – included in every latency sample
+uint64_t clockOverheadNs() {
+    std::vector<uint64_t> samples(1000);
+    for (auto& s : samples) {
+        auto start = Clock::now();
+        s = elapsedNs(start, Clock::now());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// One row of the matrix
+struct Result {
+    std::string op;
+    std::string type;
+    size_t size = 0;
+    size_t samples = 0;       // Timed operations behind the percentiles
+    double itemsPerSec = 0;   // Elements added, removed-scanned, printed or traversed per second
+    uint64_t p50Ns = 0;
+    uint64_t p99Ns = 0;
+};
+
+// Latency samples and the throughput they add up to
+class Stats {
+private:
+    std::vector<uint64_t> samples;
+    uint64_t totalNs = 0;
+    size_t items = 0;
+
+public:
+    // Records one timed operation that processed count elements
+    void record(uint64_t ns, size_t count) {
+        samples.push_back(ns);
+        totalNs += ns;
+        items += count;
+    }
+
+    // Records a latency sample that is left out of the throughput
+    void sample(uint64_t ns) {
+        samples.push_back(ns);
+    }
+
+    // Adds throughput-only time (operations not individually timed)
+    void addBulk(uint64_t ns, size_t count) {
+        totalNs += ns;
+        items += count;
+    }
+
+    Result result(const std::string& op, const std::string& type, size_t size) {
+        std::sort(samples.begin(), samples.end());
+        auto rank = [this](double q) {
+            size_t i = static_cast<size_t>(std::ceil(q * static_cast<double>(samples.size())));
+            return samples.empty() ? 0 : samples[std::max<size_t>(i, 1) - 1];
+        };
+        Result r;
+        r.op = op;
+        r.type = type;
+        r.size = size;
+        r.samples = samples.size();
+        r.itemsPerSec = totalNs ? static_cast<double>(items) * 1e9 / static_cast<double>(totalNs) : 0;
+        r.p50Ns = rank(0.50);
+        r.p99Ns = rank(0.99);
+        return r;
+    }
+};
+
+// Stream buffer that discards what is written – operator<< cost without I/O
+class NullBuffer : public std::streambuf {
+private:
+    char buffer[1 << 16];
+
+protected:
+    int overflow(int ch) override {
+        setp(buffer, buffer + sizeof(buffer));
+        return traits_type::not_eof(ch);
+    }
+};
+
+// Element values: key -> T
+template<typename T> T valueOf(uint32_t key);
+template<> int valueOf<int>(uint32_t key) { return static_cast<int>(key); }
+template<> double valueOf<double>(uint32_t key) { return static_cast<double>(key) / 4; }
+template<> char valueOf<char>(uint32_t key) { return static_cast<char>(key); }
+template<> std::string valueOf<std::string>(uint32_t key) { return std::to_string(key); }
+
+template<typename T> const char* typeName();
+template<> const char* typeName<int>() { return "int"; }
+template<> const char* typeName<double>() { return "double"; }
+template<> const char* typeName<char>() { return "char"; }
+template<> const char* typeName<std::string>() { return "string"; }
+
+// Hands a result to an empty asm statement the optimizer must assume reads it, so the
+// work that produced it is not dropped
+template<typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Keeps traversals from being optimized away
+template<typename T>
+void consume(uint64_t& sink, const T& item) {
+    if constexpr (std::is_arithmetic<T>::value) {
+        sink += static_cast<uint64_t>(item);
+    } else {
+        sink += item.size();
+    }
+}
+
+// Repetitions for whole-container operations: about 1e7 elements per operation, 3..1000
+size_t repsFor(size_t n) {
+    return std::max<size_t>(3, std::min<size_t>(1000, 10000000 / std::max<size_t>(n, 1)));
+}
+
+// Random keys, with keys 0 .. removable-1 planted at evenly spaced positions so every
+// remove() finds its value
+template<typename T>
+std::vector<T> makeSource(size_t n, size_t removable) {
+    std::vector<uint32_t> keys(n);
+    uint32_t seed = 12345;
+    for (auto& k : keys) {
+        seed = seed * 1103515245u + 12345u;
+        k = seed;
+    }
+    for (size_t j = 0; j < removable; ++j) {
+        keys[j * (n / removable)] = static_cast<uint32_t>(j);
+    }
+    std::vector<T> source;
+    source.reserve(n);
+    for (uint32_t k : keys) source.push_back(valueOf<T>(k));
+    return source;
+}
+
+// n adds into an empty container, repeated: untimed passes give throughput, a second
+// pass times up to 100,000 evenly spaced adds individually
+template<typename T>
+Result benchAdd(const std::vector<T>& source, size_t reps) {
+    size_t n = source.size();
+    Stats stats;
+    size_t fills = std::max<size_t>(1, reps / 10);
+    for (size_t f = 0; f < fills; ++f) {
+        MyContainer<T> c;
+        auto start = Clock::now();
+        for (const T& v : source) c.add(v);
+        stats.addBulk(elapsedNs(start, Clock::now()), n);
+    }
+    size_t stride = std::max<size_t>(1, n * fills / 100000);
+    for (size_t f = 0; f < fills; ++f) {
+        MyContainer<T> c;
+        for (size_t i = 0; i < n; ++i) {
+            if ((f * n + i) % stride == 0) {
+                auto start = Clock::now();
+                c.add(source[i]);
+                auto stop = Clock::now();
+                stats.sample(elapsedNs(start, stop));
+            } else {
+                c.add(source[i]);
+            }
+        }
+    }
+    return stats.result("add", typeName<T>(), n);
+}
+
+// remove() of planted values, each scanning the whole container
+template<typename T>
+Result benchRemove(const std::vector<T>& source, size_t removable) {
+    MyContainer<T> c(source.begin(), source.end());
+    Stats stats;
+    for (size_t j = 0; j < removable; ++j) {
+        size_t scanned = c.size();
+        T value = valueOf<T>(static_cast<uint32_t>(j));
+        auto start = Clock::now();
+        c.remove(value);
+        stats.record(elapsedNs(start, Clock::now()), scanned);
+    }
+    return stats.result("remove", typeName<T>(), source.size());
+}
+
+// Times reps runs of fn(), each processing n elements; reset() runs untimed before each
+template<typename T, typename Reset, typename Fn>
+Result timeRuns(const std::string& op, size_t n, size_t reps, Reset reset, Fn fn) {
+    Stats stats;
+    for (size_t r = 0; r < reps; ++r) {
+        reset();
+        auto start = Clock::now();
+        fn();
+        stats.record(elapsedNs(start, Clock::now()), n);
+    }
+    return stats.result(op, typeName<T>(), n);
+}
+
+// Builds a view and walks all of it
+template<typename View>
+void traverse(const View& view, uint64_t& sink) {
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        consume(sink, *it);
+    }
+}
+
+// Every operation for one element type and size
+template<typename T>
+void benchCase(size_t n, std::vector<Result>& results) {
+    size_t reps = repsFor(n);
+    size_t removable = std::max<size_t>(1, std::min<size_t>({reps, n / 8, std::is_same<T, char>::value ? 32 : reps}));
+    std::vector<T> source = makeSource<T>(n, removable);
+    uint64_t sink = 0;
+    auto none = [] {};
+
+    results.push_back(timeRuns<T>("construct", n, reps, none, [&] {
+        MyContainer<T> c(source.begin(), source.end());
+        sink += c.size();
+    }));
+    results.push_back(benchAdd(source, reps));
+    results.push_back(benchRemove(source, removable));
+
+    MyContainer<T> c(source.begin(), source.end());
+    NullBuffer nullBuffer;
+    std::ostream out(&nullBuffer);
+    results.push_back(timeRuns<T>("operator<<", n, reps, none, [&] { out << c; }));
+
+    // Every sample of a sorted view includes the sort
+    auto dropIndex = [&] { c.dropSortIndex(); };
+    results.push_back(timeRuns<T>("ascendingOrder", n, reps, dropIndex, [&] { traverse(c.ascendingOrder(), sink); }));
+    results.push_back(timeRuns<T>("descendingOrder", n, reps, dropIndex, [&] { traverse(c.descendingOrder(), sink); }));
+    results.push_back(timeRuns<T>("sideCrossOrder", n, reps, dropIndex, [&] { traverse(c.sideCrossOrder(), sink); }));
+    results.push_back(timeRuns<T>("reverseOrder", n, reps, none, [&] { traverse(c.reverseOrder(), sink); }));
+    results.push_back(timeRuns<T>("order", n, reps, none, [&] { traverse(c.order(), sink); }));
+    results.push_back(timeRuns<T>("middleOutOrder", n, reps, none, [&] { traverse(c.middleOutOrder(), sink); }));
+
+    doNotOptimize(sink);
+}
+
+// Prints one row: operation, percentiles and throughput
+void print(const Result& r) {
+    std::cout << "  " << std::left << std::setw(18) << r.op
+              << std::right << std::setw(12) << r.p50Ns << " ns p50"
+              << std::setw(12) << r.p99Ns << " ns p99"
+              << std::setw(12) << std::fixed << std::setprecision(2) << r.itemsPerSec / 1e6 << " M/s"
+              << std::setw(8) << r.samples << " samples" << std::endl;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results, uint64_t overheadNs) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+    out << "{\n  \"clock_overhead_ns\": " << overheadNs << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"op\": \"" << r.op << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size
+            << ", \"samples\": " << r.samples << ", \"items_per_s\": " << std::fixed << std::setprecision(1)
+            << r.itemsPerSec << ", \"p50_ns\": " << r.p50Ns << ", \"p99_ns\": " << r.p99Ns << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Value of "key": in one result line written by writeJson
+std::string field(const std::string& line, const std::string& key) {
+    std::string tag = "\"" + key + "\": ";
+    size_t at = line.find(tag);
+    if (at == std::string::npos) {
+        throw std::runtime_error("Baseline entry without " + key + ": " + line);
+    }
+    at += tag.size();
+    if (line[at] == '"') {
+        return line.substr(at + 1, line.find('"', at + 1) - at - 1);
+    }
+    return line.substr(at, line.find_first_of(",}", at) - at);
+}
+
+// Results of an earlier run, keyed by op/type/size
+std::map<std::string, Result> readJson(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    std::map<std::string, Result> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find("\"op\"") == std::string::npos) continue;
+        Result r;
+        r.op = field(line, "op");
+        r.type = field(line, "type");
+        r.size = std::stoul(field(line, "size"));
+        r.samples = std::stoul(field(line, "samples"));
+        r.itemsPerSec = std::stod(field(line, "items_per_s"));
+        r.p50Ns = std::stoull(field(line, "p50_ns"));
+        r.p99Ns = std::stoull(field(line, "p99_ns"));
+        results[r.op + "/" + r.type + "/" + std::to_string(r.size)] = r;
+    }
+    return results;
+}
+
+// Prints throughput and p99 against the baseline; returns the number of rows whose
+// throughput fell by more than thresholdPercent
+size_t compare(const std::vector<Result>& results, const std::map<std::string, Result>& baseline,
+               double thresholdPercent) {
+    std::cout << "Against baseline (throughput ratio, p99 ratio; > 1 = faster / slower tail)" << std::endl;
+    size_t regressions = 0;
+    for (const Result& r : results) {
+        auto it = baseline.find(r.op + "/" + r.type + "/" + std::to_string(r.size));
+        if (it == baseline.end() || it->second.itemsPerSec <= 0) continue;
+        double speed = r.itemsPerSec / it->second.itemsPerSec;
+        double tail = it->second.p99Ns ? static_cast<double>(r.p99Ns) / static_cast<double>(it->second.p99Ns) : 0;
+        bool regressed = speed < 1 - thresholdPercent / 100;
+        regressions += regressed;
+        std::cout << "  " << std::left << std::setw(32) << (r.op + " " + r.type + " " + std::to_string(r.size))
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(8) << speed << "x"
+                  << std::setw(8) << tail << "x" << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+
+// Comma-separated list
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> parts;
+    std::stringstream in(list);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+// Runs every case of one type whose data fits the memory limit
+template<typename T>
+void benchType(const std::vector<size_t>& sizes, size_t maxMb, std::vector<Result>& results) {
+    for (size_t n : sizes) {
+        // Source, container, one view copy and the sort index alive at once
+        double estimateMb = static_cast<double>(n) * (sizeof(T) * 4 + sizeof(size_t)) / (1 << 20);
+        std::cout << typeName<T>() << ", " << n << " elements" << std::endl;
+        if (estimateMb > static_cast<double>(maxMb)) {
+            std::cout << "  skipped: needs about " << static_cast<size_t>(estimateMb)
+                      << " MB (raise --max-mb)" << std::endl;
+            continue;
+        }
+        size_t first = results.size();
+        benchCase<T>(n, results);
+        for (size_t i = first; i < results.size(); ++i) print(results[i]);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    std::vector<std::string> types = {"int", "double", "char", "string"};
+    std::string jsonPath;
+    std::string baselinePath;
+    double threshold = 10;
+    size_t maxMb = 4096;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--sizes") {
+                sizes.clear();
+                for (const auto& s : split(value)) sizes.push_back(static_cast<size_t>(std::stod(s)));
+            } else if (arg == "--types") {
+                types = split(value);
+            } else if (arg == "--json") {
+                jsonPath = value;
+            } else if (arg == "--baseline") {
+                baselinePath = value;
+            } else if (arg == "--threshold") {
+                threshold = std::stod(value);
+            } else if (arg == "--max-mb") {
+                maxMb = std::stoul(value);
+            } else {
+                throw std::invalid_argument("Unknown option " + arg);
+            }
+        }
+
+        uint64_t overheadNs = clockOverheadNs();
+        std::cout << "Latency samples include about " << overheadNs << " ns of clock overhead" << std::endl;
+
+        std::vector<Result> results;
+        for (const auto& type : types) {
+            if (type == "int") benchType<int>(sizes, maxMb, results);
+            else if (type == "double") benchType<double>(sizes, maxMb, results);
+            else if (type == "char") benchType<char>(sizes, maxMb, results);
+            else if (type == "string") benchType<std::string>(sizes, maxMb, results);
+            else throw std::invalid_argument("Unknown type " + type);
+        }
+
+        if (!jsonPath.empty()) {
+            writeJson(jsonPath, results, overheadNs);
+            std::cout << "Wrote " << jsonPath << std::endl;
+        }
+        if (!baselinePath.empty() && compare(results, readJson(baselinePath), threshold) > 0) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "benchsuite: " << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -1,6 +1,25 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define MYCONTAINER_STATS  // The tests also check the instrumentation counters
 #include <doctest/doctest.h>
 #include "MyContainer.hpp"
+#include "ConcurrentContainer.hpp"
+#include "MappedContainer.hpp"
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <memory_resource>
+#include <sstream>
+#include <iomanip>
+#include <system_error>
+#include <unistd.h>
+#include <fstream>
+#include <cstdio>
+#include <limits>
+#include <set>
 
 using namespace genericContainer;
 
@@ -272,3 +291,1587 @@ TEST_CASE("Order iterator bracket access []") {
 
     CHECK_THROWS_AS(it[3], std::out_of_range);
 }
+
+TEST_CASE("Sorted views share a cached sort index until the container changes") {
+    MyContainer<int> c;
+    c.add(3);
+    c.add(1);
+    c.add(2);
+
+    auto asc1 = c.ascendingOrder();
+    auto asc2 = c.ascendingOrder();
+    CHECK(asc1.begin() == asc2.begin()); // same underlying sorted data
+
+    c.add(0);
+    auto asc3 = c.ascendingOrder();
+    CHECK(*asc3.begin() == 0);
+    CHECK(*asc1.begin() == 1);           // old view keeps its own snapshot
+
+    auto desc = c.descendingOrder();
+    std::vector<int> result;
+    for (auto it = desc.begin(); it != desc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{3, 2, 1, 0});
+
+    c.remove(3);
+    auto sc = c.sideCrossOrder();
+    result.clear();
+    for (auto it = sc.begin(); it != sc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{0, 2, 1});
+
+    // Dropping the cache sorts again on the next view; existing views are untouched
+    stats::reset();
+    c.ascendingOrder();
+    c.dropSortIndex();
+    auto asc4 = c.ascendingOrder();
+    CHECK(stats::snapshot()[stats::Sort].calls == 1);
+    CHECK(*asc4.begin() == 0);
+    CHECK(*sc.begin() == 0);
+}
+
+TEST_CASE("Borrowing views iterate in place and detect modification") {
+    MyContainer<int> c;
+    c.add(1);
+    c.add(2);
+    c.add(3);
+
+    auto o = c.orderView();
+    auto r = c.reverseOrderView();
+    auto m = c.middleOutOrderView();
+
+    std::vector<int> result;
+    for (auto it = o.begin(); it != o.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{1, 2, 3});
+
+    result.clear();
+    for (auto it = r.begin(); it != r.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{3, 2, 1});
+
+    result.clear();
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{2, 1, 3});
+
+    auto it = o.begin();
+    c.add(4);
+    CHECK_THROWS_AS(*it, std::logic_error);
+    CHECK_THROWS_AS(*r.begin(), std::logic_error);
+    CHECK_THROWS_AS(*m.begin(), std::logic_error);
+    CHECK(*c.orderView().begin() == 1);
+
+    // A view whose container was emptied since is stale, not empty
+    auto m2 = c.middleOutOrderView();
+    c.removeIf([](int) { return true; });
+    CHECK_THROWS_AS(m2.begin(), std::logic_error);
+    CHECK_THROWS_AS(m2.end(), std::logic_error);
+
+    MyContainer<int> empty;
+    CHECK_THROWS_AS(empty.orderView(), std::invalid_argument);
+}
+
+TEST_CASE("removeIf and removeAll") {
+    MyContainer<int> c;
+    for (int i = 0; i < 10; ++i) {
+        c.add(i);
+    }
+
+    CHECK(c.removeIf([](int x) { return x % 2 == 0; }) == 5);
+    CHECK(c.size() == 5);
+    CHECK(c.removeIf([](int x) { return x > 100; }) == 0);
+
+    c.add(3);
+    CHECK(c.removeAll(3, 7, 42) == 3);
+    std::ostringstream oss;
+    oss << c;
+    CHECK(oss.str() == "[ 1 5 9 ]");
+
+    std::vector<int> ids = {9, 1, 9};
+    CHECK(c.removeAll(ids) == 2);
+    CHECK(c.size() == 1);
+    CHECK(*c.ascendingOrder().begin() == 5);
+    CHECK_THROWS_AS(c.remove(1), std::invalid_argument);
+}
+
+TEST_CASE("removeAll with std::string values") {
+    MyContainer<std::string> c;
+    c.add("a");
+    c.add("b");
+    c.add("c");
+    CHECK(c.removeAll(std::string("b")) == 1);
+    CHECK(c.removeAll(std::vector<std::string>{"a", "c"}) == 2);
+    CHECK(c.size() == 0);
+}
+
+TEST_CASE("Bulk construction and ingestion") {
+    MyContainer<int> c{5, 3, 8};
+    CHECK(c.size() == 3);
+
+    int raw[] = {1, 2};
+    c.addRange(raw, raw + 2);
+    c.reserve(100);
+    c.emplace(9);
+    std::ostringstream oss;
+    oss << c;
+    CHECK(oss.str() == "[ 5 3 8 1 2 9 ]");
+    CHECK(*c.ascendingOrder().begin() == 1);
+
+    MyContainer<int> fromArray(raw, 2);
+    CHECK(fromArray.size() == 2);
+    const int* none = nullptr;
+    CHECK_THROWS_AS(MyContainer<int>(none, 3), std::invalid_argument);
+    CHECK_THROWS_AS((MyContainer<std::string, SegmentedStorage<std::string>>(nullptr, 1)), std::invalid_argument);
+    CHECK(MyContainer<int>(none, 0).size() == 0);
+
+    std::vector<std::string> words = {"b", "a"};
+    MyContainer<std::string> fromRange(words.begin(), words.end());
+    fromRange.emplace(3, 'z');
+    std::ostringstream oss2;
+    oss2 << fromRange;
+    CHECK(oss2.str() == "[ b a zzz ]");
+}
+
+TEST_CASE("SortedIndex by value and by permutation") {
+    std::vector<std::string> words = {"pear", "apple", "fig"};
+    auto byValue = SortedIndex<std::string>::byValue(words);
+    auto byPerm = SortedIndex<std::string>::byPermutation(words);
+    CHECK_FALSE(byValue.isPermutation());
+    CHECK(byPerm.isPermutation());
+    CHECK(byPerm.size() == 3);
+    CHECK(byPerm.at(0) == "apple");
+    CHECK(&byPerm.at(2) == &words[0]); // dereferences into the original storage
+    CHECK(byValue.at(1) == "fig");
+    CHECK_THROWS_AS(byPerm.at(3), std::out_of_range);
+}
+
+TEST_CASE("Sorted views of std::string use a permutation index when asked") {
+    MyContainer<std::string> c;
+    c.add("pear");
+    c.add("apple");
+    c.add("fig");
+    c.setPermutationSort(true);
+
+    auto asc = c.ascendingOrder();
+    std::vector<std::string> result;
+    for (auto it = asc.begin(); it != asc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<std::string>{"apple", "fig", "pear"});
+    CHECK(*c.descendingOrder().begin() == "pear");
+    CHECK(c.sideCrossOrder().begin()[1] == "pear");
+
+    MyContainer<std::string> copy = c;
+    c.add("kiwi");
+    CHECK_THROWS_AS(*asc.begin(), std::logic_error); // permutation outlived its data
+    CHECK(*copy.ascendingOrder().begin() == "apple");
+    CHECK(c.ascendingOrder().begin()[2] == "kiwi");
+}
+
+TEST_CASE("Sorted views own their data by default and outlive the container") {
+    auto* c = new MyContainer<std::string>{"pear", "apple", "fig"};
+    auto asc = c->ascendingOrder();
+    auto desc = c->descendingOrder();
+    c->add("kiwi");
+    CHECK(*asc.begin() == "apple");  // still the elements at the time of the view
+    delete c;
+    CHECK(std::vector<std::string>(asc.begin(), asc.end()) == std::vector<std::string>{"apple", "fig", "pear"});
+    CHECK(*desc.begin() == "pear");
+}
+
+TEST_CASE("OrderedStorage keeps elements sorted with insertion order intact") {
+    MyContainer<int, OrderedStorage<int>> c{5, 1, 4};
+    c.add(1);
+    c.emplace(3);
+
+    std::ostringstream oss;
+    oss << c;
+    CHECK(oss.str() == "[ 5 1 4 1 3 ]");
+
+    std::vector<int> result;
+    auto asc = c.ascendingOrder();
+    for (auto it = asc.begin(); it != asc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{1, 1, 3, 4, 5});
+
+    c.remove(1);
+    CHECK(c.size() == 3);
+    CHECK_THROWS_AS(c.remove(1), std::invalid_argument);
+    CHECK(*c.descendingOrder().begin() == 5);
+    CHECK(c.sideCrossOrder().begin()[1] == 5);
+
+    result.clear();
+    auto o = c.orderView();
+    for (auto it = o.begin(); it != o.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{5, 4, 3});
+
+    CHECK(c.removeAll(3, 5) == 2);
+    CHECK(c.removeIf([](int x) { return x == 4; }) == 1);
+    CHECK(c.size() == 0);
+
+    MyContainer<int, OrderedStorage<int>> copy;
+    copy.add(2);
+    MyContainer<int, OrderedStorage<int>> other = copy;
+    copy.remove(2);
+    CHECK(other.size() == 1);
+    CHECK(*other.ascendingOrder().begin() == 2);
+}
+
+TEST_CASE("OrderedStorage patches its sorted index between views") {
+    MyContainer<int, OrderedStorage<int>> c;
+    std::multiset<int> expected;
+    auto matches = [&] {
+        auto asc = c.ascendingOrder();
+        return std::equal(asc.begin(), asc.end(), expected.begin(), expected.end());
+    };
+    unsigned seed = 3;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int v = static_cast<int>(seed % 50);
+        if (i % 3 == 2 && expected.count(v)) {
+            c.remove(v);
+            expected.erase(v);
+        } else {
+            c.add(v);
+            expected.insert(v);
+        }
+        if (i % 40 != 0) {
+            CHECK(matches());
+        }
+    }
+
+    // A view that is still held keeps its own contents; the next one is rebuilt
+    auto held = c.ascendingOrder();
+    std::vector<int> before(held.begin(), held.end());
+    c.add(-1);
+    c.removeIf([](int v) { return v == 7; });
+    expected.insert(-1);
+    expected.erase(7);
+    CHECK(matches());
+    CHECK(std::vector<int>(held.begin(), held.end()) == before);
+
+    // Many changes at once rebuild the index from the tree
+    for (int i = 0; i < 100; ++i) {
+        c.emplace(1000 + i);
+        expected.insert(1000 + i);
+    }
+    CHECK(matches());
+
+    // Already sorted: a memory limit does not make it spill
+    c.setSortMemoryLimit(16);
+    c.add(500);
+    expected.insert(500);
+    stats::reset();
+    CHECK(matches());
+    CHECK(stats::snapshot()[stats::Sort].bytes > 0);
+}
+
+TEST_CASE("OrderedStorage removeIf unlinks duplicates individually") {
+    constexpr int n = 20000;
+    MyContainer<int, OrderedStorage<int>> c;
+    for (int i = 0; i < n; ++i) {
+        c.add(i % 4);
+    }
+    int seen = 0;
+    CHECK(c.removeIf([&seen](int x) { return x == 1 && seen++ % 2 == 0; }) == n / 8);
+    CHECK(c.removeIf([](int x) { return x == 2; }) == n / 4);
+    CHECK(c.size() == n - n / 4 - n / 8);
+    c.remove(1);  // the value index still finds the survivors
+    CHECK(c.size() == n / 2);
+    auto view = c.ascendingOrder();
+    CHECK(view.begin()[n / 4 - 1] == 0);
+    CHECK(view.begin()[n / 4] == 3);
+    auto order = c.order();
+    CHECK(order.begin()[1] == 3);
+}
+
+TEST_CASE("Lazy SortedIndex settles positions on demand") {
+    std::vector<int> data;
+    unsigned seed = 7;
+    for (int i = 0; i < 1000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        data.push_back(static_cast<int>(seed % 100)); // many duplicates
+    }
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    SortOptions lazy;
+    lazy.lazy = true;
+    auto byValue = SortedIndex<int>::byValue(data, lazy);
+    auto byPerm = SortedIndex<int>::byPermutation(data, nullptr, lazy);
+    CHECK_FALSE(byValue.isFullySorted());
+    CHECK(byValue.at(0) == expected[0]);
+    CHECK(byValue.at(999) == expected[999]);
+    CHECK_FALSE(byValue.isFullySorted());
+
+    bool allMatch = true;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        size_t pos = (i * 617) % expected.size(); // scattered access order
+        allMatch = allMatch && byValue.at(pos) == expected[pos] && byPerm.at(pos) == expected[pos];
+    }
+    CHECK(allMatch);
+    CHECK(byValue.isFullySorted());
+}
+
+TEST_CASE("Lazy sorted views give the same order") {
+    MyContainer<int> c{9, 2, 7, 4, 4, 1};
+    c.setLazySort(true);
+
+    auto desc = c.descendingOrder();
+    CHECK(*desc.begin() == 9);
+
+    std::vector<int> result;
+    auto asc = c.ascendingOrder();
+    for (auto it = asc.begin(); it != asc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{1, 2, 4, 4, 7, 9});
+
+    c.add(0);
+    CHECK(c.sideCrossOrder().begin()[1] == 9);
+    CHECK(*c.ascendingOrder().begin() == 0);
+}
+
+TEST_CASE("Unchecked iterator policy gives the same traversal") {
+    MyContainer<int> c{3, 1, 2};
+
+    std::vector<int> result;
+    auto asc = c.ascendingOrder<UncheckedIterators>();
+    for (auto it = asc.begin(); it != asc.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{1, 2, 3});
+
+    result.clear();
+    auto o = c.orderView<UncheckedIterators>();
+    for (auto it = o.begin(); it != o.end(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{3, 1, 2});
+
+    auto m = c.middleOutOrder<UncheckedIterators>();
+    CHECK(*m.begin() == 1);
+    CHECK(c.sideCrossOrder<UncheckedIterators>().begin()[1] == 3);
+
+    auto checked = c.order<CheckedIterators>();
+    CHECK_THROWS_AS(*checked.end(), std::out_of_range);
+}
+
+TEST_CASE("Order iterators are standard random access iterators") {
+    using It = MiddleOutOrder<int>::Iterator;
+    static_assert(std::is_same<std::iterator_traits<It>::iterator_category,
+                               std::random_access_iterator_tag>::value, "random access");
+
+    MyContainer<int> c{50, 10, 40, 20, 30};
+
+    auto asc = c.ascendingOrder();
+    CHECK(std::distance(asc.begin(), asc.end()) == 5);
+    CHECK(std::is_sorted(asc.begin(), asc.end()));
+    auto found = std::lower_bound(asc.begin(), asc.end(), 25);
+    CHECK(*found == 30);
+    CHECK(found - asc.begin() == 2);
+
+    auto sc = c.sideCrossOrder();
+    auto scIt = sc.begin() + 3;
+    CHECK(*scIt == 40);                 // 10 50 20 40 30
+    CHECK(*(scIt - 2) == 50);
+    CHECK(sc.end() - sc.begin() == 5);
+    CHECK((2 + sc.begin())[2] == 30);
+
+    auto m = c.middleOutOrder();
+    std::vector<int> result(m.begin(), m.end());
+    CHECK(result == std::vector<int>{40, 10, 20, 50, 30});
+    auto mIt = m.end();
+    --mIt;
+    CHECK(*mIt == 30);
+    CHECK(m.begin()[3] == 50);
+    CHECK(m.begin() < mIt);
+
+    auto rev = c.reverseOrder();
+    CHECK(std::count_if(rev.begin(), rev.end(), [](int x) { return x > 25; }) == 3);
+    CHECK(*(rev.end() - 1) == 50);
+    CHECK_THROWS_AS(rev.begin() - 1, std::out_of_range);
+
+    // Negative offsets index backwards, as it[n] == *(it + n)
+    auto desc = c.descendingOrder();
+    auto ord = c.order();
+    CHECK(asc.end()[-1] == 50);
+    CHECK(desc.end()[-1] == 10);
+    CHECK(sc.end()[-2] == 40);
+    CHECK(rev.end()[-5] == 30);
+    CHECK(ord.end()[-1] == 30);
+    CHECK(m.end()[-2] == 50);
+    CHECK(scIt[-3] == 10);
+    CHECK_THROWS_AS(asc.end()[-6], std::out_of_range);
+    CHECK_THROWS_AS(m.begin()[-1], std::out_of_range);
+    CHECK_THROWS_AS(ord.end()[0], std::out_of_range);
+}
+
+TEST_CASE("Parallel sort matches std::sort") {
+    std::vector<int> keys;
+    unsigned seed = 3;
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        keys.push_back(static_cast<int>(seed % 1000));
+    }
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    SortOptions options;
+    options.parallelThreshold = 0;
+    for (unsigned threads : {2u, 3u, 8u}) {
+        options.threads = threads;
+        std::vector<int> sorted = keys;
+        sortKeys(sorted, std::less<int>(), options);
+        CHECK(sorted == expected);
+    }
+
+    MyContainer<int> c(keys.begin(), keys.end());
+    c.setParallelSort(1000, 4);
+    auto asc = c.ascendingOrder();
+    CHECK(std::equal(asc.begin(), asc.end(), expected.begin()));
+
+    MyContainer<std::string> words{"d", "b", "a", "c", "e"};
+    words.setParallelSort(0, 2);
+    auto desc = words.descendingOrder();
+    CHECK(std::vector<std::string>(desc.begin(), desc.end()) == std::vector<std::string>{"e", "d", "c", "b", "a"});
+}
+
+// Fills a vector with pseudo-random values of both signs
+template<typename K>
+std::vector<K> radixTestKeys(size_t n) {
+    std::vector<K> keys;
+    unsigned seed = 11;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        keys.push_back(static_cast<K>(static_cast<int>(seed >> 4) - (1 << 26)) / static_cast<K>(7));
+    }
+    return keys;
+}
+
+template<typename K>
+bool radixMatchesStdSort(std::vector<K> keys) {
+    std::vector<K> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    sortKeys(keys, std::less<K>());
+    return keys == expected;
+}
+
+TEST_CASE("Radix and counting sort match std::sort") {
+    CHECK(radixMatchesStdSort(radixTestKeys<int>(3000)));
+    CHECK(radixMatchesStdSort(radixTestKeys<long long>(3000)));
+    CHECK(radixMatchesStdSort(radixTestKeys<unsigned>(3000)));
+    CHECK(radixMatchesStdSort(radixTestKeys<short>(3000)));
+    CHECK(radixMatchesStdSort(radixTestKeys<float>(3000)));
+
+    std::vector<double> doubles = radixTestKeys<double>(3000);
+    doubles.insert(doubles.end(), {-0.0, 0.0, 1e300, -1e300, 5e-324, -5e-324,
+                                   std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()});
+    CHECK(radixMatchesStdSort(doubles));
+
+    CHECK(radixMatchesStdSort(std::vector<char>{'z', 'a', '\xF0', 'm', '\0', 'a'}));
+    CHECK(radixMatchesStdSort(std::vector<signed char>{-128, 127, 0, -1, 1, -128}));
+    CHECK(radixMatchesStdSort(std::vector<unsigned char>{255, 0, 128, 127, 1}));
+    CHECK(radixMatchesStdSort(std::vector<bool>{true, false, true}));
+
+    MyContainer<double> c{2.5, -1.0, 0.0, -7.25};
+    auto asc = c.ascendingOrder();
+    CHECK(std::vector<double>(asc.begin(), asc.end()) == std::vector<double>{-7.25, -1.0, 0.0, 2.5});
+}
+
+// Runs every compaction kernel on keys and compares with std::remove
+template<typename K>
+bool compactionMatchesStdRemove(const std::vector<K>& keys, K value) {
+    std::vector<K> expected = keys;
+    expected.erase(std::remove(expected.begin(), expected.end(), value), expected.end());
+    auto run = [&](size_t (*kernel)(K*, size_t, const K&)) {
+        std::vector<K> work = keys;
+        size_t removed = kernel(work.data(), work.size(), value);
+        work.resize(work.size() - removed);
+        // Bitwise, so NaN survivors compare equal
+        return work.size() == expected.size() && (work.empty() ||
+               std::memcmp(work.data(), expected.data(), work.size() * sizeof(K)) == 0);
+    };
+    bool ok = run(&removeEqual<K>) && run(&compaction::removeEqualScalar<K>);
+#ifdef MYCONTAINER_SIMD_X86
+    if constexpr (compaction::Vectorizable<K>::value) {
+        ok = ok && run(&compaction::removeEqualSse2<K>);
+        if (cpuHasAvx2()) {
+            ok = ok && run(&compaction::removeEqualAvx2<K>);
+        }
+    }
+#endif
+    return ok;
+}
+
+// Keys drawn from a small range so value appears often, including in runs
+template<typename K>
+std::vector<K> compactionTestKeys(size_t n) {
+    std::vector<K> keys;
+    unsigned seed = 7;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        keys.push_back(static_cast<K>(static_cast<int>((seed >> 16) % 5) - 2));
+    }
+    return keys;
+}
+
+template<typename K>
+bool compactionMatchesForAllSizes() {
+    for (size_t n : {0, 1, 3, 7, 8, 9, 15, 16, 17, 33, 1000}) {
+        for (int value = -3; value <= 2; ++value) {
+            if (!compactionMatchesStdRemove(compactionTestKeys<K>(n), static_cast<K>(value))) {
+                return false;
+            }
+        }
+    }
+    return compactionMatchesStdRemove(std::vector<K>(100, K(1)), K(1));
+}
+
+TEST_CASE("SIMD compaction matches std::remove") {
+    CHECK(compactionMatchesForAllSizes<int>());
+    CHECK(compactionMatchesForAllSizes<unsigned>());
+    CHECK(compactionMatchesForAllSizes<long long>());
+    CHECK(compactionMatchesForAllSizes<float>());
+    CHECK(compactionMatchesForAllSizes<double>());
+    CHECK(compactionMatchesForAllSizes<short>());
+
+    // Floating point follows ==: NaN never matches, -0.0 matches 0.0
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> special{nan, -0.0, 0.0, 1.0, nan, 0.0, -0.0, 2.0, 3.0};
+    CHECK(compactionMatchesStdRemove(special, 0.0));
+    CHECK(compactionMatchesStdRemove(special, nan));
+
+    MyContainer<int> c{4, 1, 4, 2, 4, 3, 4, 4, 5, 4};
+    CHECK(c.removeAll(4) == 6);
+    CHECK(c.size() == 4);
+    std::ostringstream out;
+    out << c;
+    CHECK(out.str() == "[ 1 2 3 5 ]");
+    CHECK_THROWS_AS(c.remove(4), std::invalid_argument);
+}
+
+TEST_CASE("Sorting networks sort small arrays") {
+    for (size_t n = 0; n <= 70; ++n) {
+        CHECK(radixMatchesStdSort(radixTestKeys<int>(n)));
+        CHECK(radixMatchesStdSort(radixTestKeys<unsigned>(n)));
+        CHECK(radixMatchesStdSort(radixTestKeys<long long>(n)));
+        CHECK(radixMatchesStdSort(radixTestKeys<float>(n)));
+        CHECK(radixMatchesStdSort(radixTestKeys<double>(n)));
+        CHECK(radixMatchesStdSort(compactionTestKeys<short>(n)));
+        CHECK(radixMatchesStdSort(compactionTestKeys<signed char>(n)));
+    }
+
+    // Keys equal to the padding value stay in the output
+    CHECK(radixMatchesStdSort(std::vector<int>{std::numeric_limits<int>::max(), 3, std::numeric_limits<int>::min(),
+                                               std::numeric_limits<int>::max(), -1}));
+    double inf = std::numeric_limits<double>::infinity();
+    CHECK(radixMatchesStdSort(std::vector<double>{inf, 1.5, -inf, inf, 0.0, -2.0}));
+
+    // The portable network, for types the AVX2 network would otherwise take
+    std::vector<int> portable = radixTestKeys<int>(64);
+    std::vector<int> portableExpected = portable;
+    std::sort(portableExpected.begin(), portableExpected.end());
+    sorting::bitonicSort<64>(portable.data());
+    CHECK(portable == portableExpected);
+
+    // Ties keep both keys: -0.0f and 0.0f are both still there after sorting
+    std::vector<float> zeros{0.0f, -0.0f, 1.0f, -0.0f, 0.0f, -1.0f, 0.0f};
+    sortKeys(zeros, std::less<float>());
+    CHECK(std::count_if(zeros.begin(), zeros.end(), [](float v) { return v == 0.0f && std::signbit(v); }) == 2);
+    CHECK(std::count_if(zeros.begin(), zeros.end(), [](float v) { return v == 0.0f && !std::signbit(v); }) == 3);
+
+    // A NaN makes the network step aside instead of dropping keys
+    std::vector<double> withNan{3.0, std::numeric_limits<double>::quiet_NaN(), 1.0, 2.0};
+    sortKeys(withNan, std::less<double>());
+    CHECK(withNan.size() == 4);
+    CHECK(std::count_if(withNan.begin(), withNan.end(), [](double v) { return v != v; }) == 1);
+
+    MyContainer<int> c{9, -4, 7, 7, 0, 12, -30, 5, 1, 2, 3};
+    auto asc = c.ascendingOrder();
+    CHECK(std::vector<int>(asc.begin(), asc.end()) == std::vector<int>{-30, -4, 0, 1, 2, 3, 5, 7, 7, 9, 12});
+    auto desc = c.descendingOrder();
+    CHECK(*desc.begin() == 12);
+}
+
+TEST_CASE("Concurrent container merges every writer's adds") {
+    constexpr int writers = 8;
+    constexpr int perWriter = 5000;
+    ConcurrentContainer<int> c(4);
+
+    // Snapshots taken while writers run must be consistent cuts: for every writer,
+    // the elements present are exactly its first k adds
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::thread reader([&] {
+        while (!done) {
+            std::vector<int> seen = c.items();
+            std::vector<int> perWriterCount(writers, 0);
+            std::vector<int> perWriterMax(writers, -1);
+            for (int v : seen) {
+                ++perWriterCount[v / perWriter];
+                perWriterMax[v / perWriter] = std::max(perWriterMax[v / perWriter], v % perWriter);
+            }
+            for (int w = 0; w < writers; ++w) {
+                if (perWriterMax[w] + 1 != perWriterCount[w]) {
+                    consistent = false;
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&c, w] {
+            for (int i = 0; i < perWriter; ++i) {
+                if (i % 2 == 0) {
+                    c.add(w * perWriter + i);
+                } else {
+                    c.emplace(w * perWriter + i);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    done = true;
+    reader.join();
+    CHECK(consistent);
+
+    CHECK(c.size() == static_cast<size_t>(writers * perWriter));
+    auto asc = c.ascendingOrder();
+    std::vector<int> expected(writers * perWriter);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(std::equal(asc.begin(), asc.end(), expected.begin(), expected.end()));
+    auto desc = c.descendingOrder();
+    CHECK(*desc.begin() == writers * perWriter - 1);
+
+    MyContainer<int> snap = c.snapshot();
+    CHECK(snap.size() == static_cast<size_t>(writers * perWriter));
+    CHECK(snap.removeIf([](int v) { return v % 2 == 1; }) == static_cast<size_t>(writers * perWriter / 2));
+    CHECK(c.size() == static_cast<size_t>(writers * perWriter));
+}
+
+TEST_CASE("Concurrent readers share one sort index of a const container") {
+    std::vector<int> data(20000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>((i * 7919) % data.size());
+    }
+    const MyContainer<int> c(data.begin(), data.end());
+
+    std::atomic<int> sorted{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&c, &sorted] {
+            auto asc = c.ascendingOrder();
+            if (std::is_sorted(asc.begin(), asc.end()) && *asc.begin() == 0) {
+                ++sorted;
+            }
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+    CHECK(sorted == 4);
+
+    // A lazy index is settled by whichever reader gets to a position first
+    MyContainer<int> lazy(data.begin(), data.end());
+    lazy.setLazySort(true);
+    const MyContainer<int>& shared = lazy;
+    std::atomic<int> correct{0};
+    readers.clear();
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&shared, &correct, r] {
+            auto asc = shared.ascendingOrder();
+            bool ok = true;
+            for (int i = r * 5000; i < (r + 1) * 5000; i += 7) {
+                ok = ok && asc.begin()[i] == i;
+            }
+            ok = ok && std::is_sorted(asc.begin(), asc.end());
+            correct += ok;
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+    CHECK(correct == 4);
+}
+
+TEST_CASE("Concurrent container views on one thread") {
+    ConcurrentContainer<int> c(1);
+    std::vector<int> values{7, 15, 6, 1, 2};
+    c.addRange(values.begin(), values.end());
+    CHECK(c.size() == 5);
+
+    auto order = c.order();
+    CHECK(std::vector<int>(order.begin(), order.end()) == values);
+    auto reverse = c.reverseOrder();
+    CHECK(std::vector<int>(reverse.begin(), reverse.end()) == std::vector<int>{2, 1, 6, 15, 7});
+    auto sideCross = c.sideCrossOrder();
+    CHECK(std::vector<int>(sideCross.begin(), sideCross.end()) == std::vector<int>{1, 15, 2, 7, 6});
+    auto middleOut = c.middleOutOrder();
+    CHECK(std::vector<int>(middleOut.begin(), middleOut.end()) == std::vector<int>{6, 15, 1, 7, 2});
+
+    // Views own their snapshot – later adds do not affect them
+    c.add(100);
+    CHECK(std::distance(order.begin(), order.end()) == 5);
+    CHECK(c.size() == 6);
+
+    ConcurrentContainer<std::string> words;
+    words.emplace(3, 'x');
+    words.add("abc");
+    auto asc = words.ascendingOrder();
+    CHECK(std::vector<std::string>(asc.begin(), asc.end()) == std::vector<std::string>{"abc", "xxx"});
+}
+
+// True if both ranges hold the same elements in the same order
+template<typename RangeA, typename RangeB>
+bool sameElements(const RangeA& a, const RangeB& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+// Applies the same adds and removals to a container with Storage and to the vector
+// storage, then compares every view and the printed output. The second half of the
+// data is runs of duplicates, for the removeIf and removeAll paths.
+template<typename Storage>
+void checkMatchesVectorStorage() {
+    constexpr int n = 10000;  // spans several chunks
+    MyContainer<int, Storage> other;
+    MyContainer<int> plain;
+    other.reserve(2 * n);
+    for (int i = 0; i < n; ++i) {
+        other.add((i * 7919) % n);
+        plain.add((i * 7919) % n);
+    }
+    for (int i = 0; i < n; ++i) {
+        other.emplace(i % 8);
+        plain.emplace(i % 8);
+    }
+    CHECK(other.size() == plain.size());
+
+    CHECK(other.removeIf([](int v) { return v % 3 == 0; }) == plain.removeIf([](int v) { return v % 3 == 0; }));
+    CHECK(other.removeIf([](int v) { return v == 1 || v == 5; }) == plain.removeIf([](int v) { return v == 1 || v == 5; }));
+    CHECK(other.removeAll(2, 4, 10) == plain.removeAll(2, 4, 10));
+    other.remove(7);
+    plain.remove(7);
+    CHECK_THROWS_AS(other.remove(7), std::invalid_argument);
+    other.emplace(n + 1);
+    plain.emplace(n + 1);
+    CHECK(other.size() == plain.size());
+
+    CHECK(sameElements(other.ascendingOrder(), plain.ascendingOrder()));
+    CHECK(sameElements(other.descendingOrder(), plain.descendingOrder()));
+    CHECK(sameElements(other.sideCrossOrder(), plain.sideCrossOrder()));
+    CHECK(sameElements(other.reverseOrderView(), plain.reverseOrderView()));
+    CHECK(sameElements(other.order(), plain.order()));
+    CHECK(sameElements(other.middleOutOrder(), plain.middleOutOrder()));
+
+    std::ostringstream otherOut, plainOut;
+    otherOut << other;
+    plainOut << plain;
+    CHECK(otherOut.str() == plainOut.str());
+}
+
+TEST_CASE("Chunked storage matches vector storage") {
+    checkMatchesVectorStorage<ChunkedStorage<int>>();
+}
+
+TEST_CASE("Chunked snapshots are immutable and share untouched chunks") {
+    constexpr int n = 3 * 4096 + 10;
+    MyContainer<int, ChunkedStorage<int>> c;
+    for (int i = 0; i < n; ++i) {
+        c.add(i);
+    }
+
+    ChunkedSnapshot<int> before = c.snapshot();
+    auto order = c.order();
+    auto reverse = c.reverseOrder();
+
+    // Appending copies only the last chunk
+    c.add(n);
+    ChunkedSnapshot<int> afterAdd = c.snapshot();
+    CHECK(before.size() == static_cast<size_t>(n));
+    CHECK(afterAdd.size() == static_cast<size_t>(n + 1));
+    CHECK(&before[0] == &afterAdd[0]);
+    CHECK(&before[2 * 4096] == &afterAdd[2 * 4096]);
+    CHECK(&before[n - 1] != &afterAdd[n - 1]);
+
+    // Removing from the third chunk rebuilds only the chunks from there on
+    c.remove(2 * 4096 + 5);
+    ChunkedSnapshot<int> afterRemove = c.snapshot();
+    CHECK(&afterAdd[4096] == &afterRemove[4096]);
+    CHECK(afterRemove[2 * 4096 + 5] == 2 * 4096 + 6);
+
+    // Views taken earlier still see the old elements
+    CHECK(std::distance(order.begin(), order.end()) == n);
+    CHECK(*(order.begin() + (2 * 4096 + 5)) == 2 * 4096 + 5);
+    CHECK(*reverse.begin() == n - 1);
+
+    // Copies of the container share chunks until one side changes
+    MyContainer<int, ChunkedStorage<int>> copy = c;
+    copy.add(-1);
+    CHECK(copy.size() == c.size() + 1);
+    CHECK(&copy.snapshot()[0] == &c.snapshot()[0]);
+    CHECK(*(c.order().end() - 1) == n);
+
+    MyContainer<std::string, ChunkedStorage<std::string>> words{"pear", "apple", "fig"};
+    auto asc = words.ascendingOrder();
+    CHECK(std::vector<std::string>(asc.begin(), asc.end()) == std::vector<std::string>{"apple", "fig", "pear"});
+    CHECK(words.snapshot().toVector() == std::vector<std::string>{"pear", "apple", "fig"});
+
+    MyContainer<int, ChunkedStorage<int>> empty;
+    CHECK(empty.snapshot().empty());
+    CHECK_THROWS_AS(empty.order(), std::invalid_argument);
+}
+
+// Memory resource that counts the allocations it forwards to the heap
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Allocator-aware container allocates from its resource") {
+    CountingResource counting;
+    pmr::MyContainer<int> c(&counting);
+    for (int v : {5, 3, 9, 1, 7}) {
+        c.add(v);
+    }
+    CHECK(counting.allocations > 0);
+
+    auto asc = c.ascendingOrder();
+    CHECK(std::vector<int>(asc.begin(), asc.end()) == std::vector<int>{1, 3, 5, 7, 9});
+    auto order = c.orderView();
+    CHECK(std::vector<int>(order.begin(), order.end()) == std::vector<int>{5, 3, 9, 1, 7});
+    CHECK(c.removeAll(3, 9) == 2);
+    std::ostringstream out;
+    out << c;
+    CHECK(out.str() == "[ 5 1 7 ]");
+
+    // Permutation sort indices work over any allocator
+    MyContainer<std::string, std::pmr::polymorphic_allocator<std::string>> words(&counting);
+    words.add("pear");
+    words.add("apple");
+    words.add("fig");
+    auto desc = words.descendingOrder();
+    CHECK(std::vector<std::string>(desc.begin(), desc.end()) == std::vector<std::string>{"pear", "fig", "apple"});
+}
+
+TEST_CASE("Arena-backed views stop allocating once the resource is warm") {
+    MyContainer<int> c{4, 8, 15, 16, 23, 42};
+    CountingResource counting;
+    std::pmr::unsynchronized_pool_resource pool(&counting);
+
+    long long sum = 0;
+    size_t afterWarmUp = 0;
+    for (int request = 0; request < 100; ++request) {
+        auto order = c.order(&pool);
+        auto reverse = c.reverseOrder(&pool);
+        auto middleOut = c.middleOutOrder(&pool);
+        sum += *order.begin() + *reverse.begin() + *middleOut.begin();
+        if (request == 0) {
+            afterWarmUp = counting.allocations;
+        }
+    }
+    CHECK(counting.allocations == afterWarmUp);
+    CHECK(sum == 100 * (4 + 42 + 16));
+
+    // A fixed buffer with no upstream: any heap fallback would throw
+    alignas(std::max_align_t) char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto middleOut = c.middleOutOrder(&arena);
+    CHECK(std::vector<int>(middleOut.begin(), middleOut.end()) == std::vector<int>{16, 15, 23, 8, 42, 4});
+
+    MyContainer<int> empty;
+    CHECK_THROWS_AS(empty.order(&arena), std::invalid_argument);
+}
+
+TEST_CASE("Instrumentation counts views, sorts and removals") {
+    stats::reset();
+    MyContainer<int> c{5, 1, 7, 3};
+
+    auto asc = c.ascendingOrder();
+    auto desc = c.descendingOrder();   // Shares the index – no second sort
+    auto order = c.order();            // Copies the four elements
+    auto borrowed = c.orderView();     // Copies nothing
+    c.remove(7);
+    auto cross = c.sideCrossOrder();   // Sorts again after the removal
+
+    stats::Snapshot s = stats::snapshot();
+    CHECK(s[stats::AscendingView].calls == 1);
+    CHECK(s[stats::DescendingView].calls == 1);
+    CHECK(s[stats::SideCrossView].calls == 1);
+    CHECK(s[stats::OrderView].calls == 2);
+    CHECK(s[stats::OrderView].elements == 4);
+    CHECK(s[stats::OrderView].bytes == 4 * sizeof(int));
+    CHECK(s[stats::ReverseView].calls == 0);
+    CHECK(s[stats::Sort].calls == 2);
+    CHECK(s[stats::Sort].elements == 4 + 3);
+    CHECK(s[stats::Sort].bytes >= (4 + 3) * sizeof(int));
+    CHECK(s[stats::Remove].calls == 1);
+    CHECK(s[stats::Remove].elements == 4);
+
+    CHECK(s.toText().find("order calls=2 elements=4 bytes=16") != std::string::npos);
+    std::string json = s.toJson();
+    CHECK(json.rfind("{\"enabled\": true, \"operations\": {\"ascendingOrder\": {\"calls\": 1", 0) == 0);
+    CHECK(json.find("\"remove\": {\"calls\": 1, \"elements\": 4, \"bytes\": 0, ") != std::string::npos);
+
+    // Collection can be paused at run time
+    CHECK(stats::enabled());
+    stats::setEnabled(false);
+    c.remove(5);
+    CHECK(stats::snapshot()[stats::Remove].calls == 1);
+    CHECK(stats::snapshot().toJson().rfind("{\"enabled\": false", 0) == 0);
+    stats::setEnabled(true);
+
+    // Chunked storage hands views a shared snapshot
+    MyContainer<int, ChunkedStorage<int>> chunked{1, 2, 3};
+    auto view = chunked.order();
+    CHECK(stats::snapshot()[stats::OrderView].elements == 4);
+
+    stats::reset();
+    CHECK(stats::snapshot()[stats::OrderView].calls == 0);
+}
+
+// Formats like the element-by-element operator<< did
+template<typename T>
+std::string slowFormat(const std::vector<T>& items, std::ostream& style) {
+    std::ostringstream out;
+    out.copyfmt(style);
+    out << "[ ";
+    for (const T& item : items) out << item << " ";
+    out << "]";
+    return out.str();
+}
+
+TEST_CASE("Buffered formatting matches stream formatting") {
+    std::ostringstream plain;
+    std::vector<int> ints{0, -1, 42, 2147483647, -2147483647 - 1};
+    std::vector<double> doubles{0.0, -0.0, 3.14159265358979, 1e-7, 123456789.0, -2.5, 1e300};
+    std::vector<char> chars{'a', 'Z', ' ', '!'};
+    std::vector<std::string> words{"pear", "", std::string(100000, 'x')};
+
+    auto same = [](const auto& items, std::ostream& style) {
+        using T = typename std::decay_t<decltype(items)>::value_type;
+        MyContainer<T> c(items.begin(), items.end());
+        std::ostringstream out;
+        out.copyfmt(style);
+        out << c;
+        CHECK(out.str() == slowFormat(items, style));
+    };
+    same(ints, plain);
+    same(doubles, plain);
+    same(chars, plain);
+    same(words, plain);
+    same(std::vector<bool>{true, false}, plain);
+
+    // Non-default stream state falls back to per-element formatting
+    std::ostringstream styled;
+    styled << std::hex << std::showpos << std::setprecision(12);
+    same(ints, styled);
+    same(doubles, styled);
+    std::ostringstream precise;
+    precise << std::setprecision(15);
+    same(doubles, precise);
+
+    // A precision longer than the room kept for a number: denormals print hundreds of digits
+    std::ostringstream huge;
+    huge << std::setprecision(1000);
+    std::vector<double> denormals(200, std::numeric_limits<double>::denorm_min());
+    denormals.push_back(-std::numeric_limits<double>::min() / 3);
+    same(denormals, huge);
+    std::vector<long double> longDenormals(10, std::numeric_limits<long double>::denorm_min());
+    huge << std::setprecision(100000);
+    same(longDenormals, huge);
+
+    // Larger than one 64 KiB block
+    std::vector<int> many(100000);
+    std::iota(many.begin(), many.end(), -50000);
+    same(many, plain);
+
+    MyContainer<int> empty;
+    std::ostringstream out;
+    out << empty;
+    CHECK(out.str() == "[ ]");
+}
+
+TEST_CASE("Views can be written to a stream or a file descriptor") {
+    MyContainer<int> c{7, 15, 6, 1, 2};
+    std::ostringstream out;
+    writeFormatted(out, c.sideCrossOrder());
+    CHECK(out.str() == "[ 1 15 2 7 6 ]");
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    writeFormatted(fds[1], c.ascendingOrder());
+    MyContainer<double> d{0.5, 1.25};
+    writeFormatted(fds[1], d.orderView());
+    close(fds[1]);
+    std::string piped;
+    char chunk[256];
+    for (ssize_t got; (got = read(fds[0], chunk, sizeof(chunk))) > 0;) piped.append(chunk, static_cast<size_t>(got));
+    close(fds[0]);
+    CHECK(piped == "[ 1 2 6 7 15 ][ 0.5 1.25 ]");
+
+    CHECK_THROWS_AS(writeFormatted(-1, c.order()), std::system_error);
+}
+
+// Path of a scratch file that is removed when the test ends
+struct TempFile {
+    std::string path;
+
+    explicit TempFile(const std::string& name) : path("/tmp/mycontainer-test-" + name + "-" + std::to_string(getpid())) {}
+    ~TempFile() { std::remove(path.c_str()); }
+};
+
+TEST_CASE("Binary save and load round trip") {
+    TempFile file("roundtrip");
+    MyContainer<double> c{2.5, -1.0, 7.25, 0.0, 3.0};
+    c.save(file.path);
+
+    MyContainer<double> loaded{42.0};
+    loaded.load(file.path);
+    std::ostringstream a, b;
+    a << c;
+    b << loaded;
+    CHECK(a.str() == b.str());
+    auto asc = loaded.ascendingOrder();
+    CHECK(std::vector<double>(asc.begin(), asc.end()) == std::vector<double>{-1.0, 0.0, 2.5, 3.0, 7.25});
+
+    // Other storage policies write and read the same format
+    MyContainer<double, ChunkedStorage<double>> chunked;
+    chunked.load(file.path);
+    CHECK(chunked.size() == 5);
+    chunked.save(file.path, true);
+    MyContainer<double, OrderedStorage<double>> ordered;
+    ordered.load(file.path);
+    auto orderedAsc = ordered.ascendingOrder();
+    CHECK(*orderedAsc.begin() == -1.0);
+
+    MyContainer<double> empty;
+    empty.save(file.path, true);
+    loaded.load(file.path);
+    CHECK(loaded.size() == 0);
+}
+
+struct Point {
+    int x;
+    int y;
+    char label[24];
+    bool operator<(const Point& other) const { return x < other.x || (x == other.x && y < other.y); }
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+};
+
+TEST_CASE("A stored permutation serves sorted views without a sort") {
+    TempFile file("permutation");
+    std::vector<int> values(1000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 7919) % 1000) - 500;
+    MyContainer<int> c(values.begin(), values.end());
+    c.save(file.path, true);
+
+    stats::reset();
+    MyContainer<int> loaded;
+    loaded.load(file.path);
+    auto asc = loaded.ascendingOrder();
+    CHECK(std::is_sorted(asc.begin(), asc.end()));
+    CHECK(*asc.begin() == -500);
+    CHECK(stats::snapshot()[stats::Sort].calls == 0);
+
+    // Permutation mode: the index keeps pointing into the loaded storage
+    MyContainer<Point> points;
+    points.add(Point{3, 1, "c"});
+    points.add(Point{1, 2, "a"});
+    points.add(Point{2, 0, "b"});
+    points.save(file.path, true);
+    MyContainer<Point> loadedPoints;
+    loadedPoints.setPermutationSort(true);
+    loadedPoints.load(file.path);
+    auto desc = loadedPoints.descendingOrder();
+    CHECK(std::string(desc.begin()->label) == "c");
+    CHECK(stats::snapshot()[stats::Sort].calls == 0);
+    loadedPoints.add(Point{0, 0, "z"});
+    CHECK_THROWS_AS(*desc.begin(), std::logic_error);  // borrowed the storage that changed
+    CHECK(std::string(loadedPoints.ascendingOrder().begin()->label) == "z");
+
+    // Value mode (the default) gathers the stored order into a view of its own
+    stats::reset();
+    MyContainer<Point> copiedPoints;
+    copiedPoints.load(file.path);
+    auto ownAsc = copiedPoints.ascendingOrder();
+    CHECK(stats::snapshot()[stats::Sort].calls == 0);
+    copiedPoints.add(Point{0, 0, "z"});
+    CHECK(std::string(ownAsc.begin()->label) == "a");
+}
+
+TEST_CASE("Mapped container serves every view from the file") {
+    TempFile file("mapped");
+    MyContainer<int> c{7, 15, 6, 1, 2};
+    for (bool withIndex : {false, true}) {
+        c.save(file.path, withIndex);
+        auto view = [] (const auto& v) { return std::vector<int>(v.begin(), v.end()); };
+        auto mapped = std::make_unique<MappedContainer<int>>(file.path);
+        CHECK(mapped->size() == 5);
+        CHECK(mapped->hasPermutation() == withIndex);
+        CHECK(view(mapped->ascendingOrder()) == view(c.ascendingOrder()));
+        CHECK(view(mapped->descendingOrder()) == view(c.descendingOrder()));
+        CHECK(view(mapped->sideCrossOrder()) == view(c.sideCrossOrder()));
+        CHECK(view(mapped->reverseOrder()) == view(c.reverseOrder()));
+        CHECK(view(mapped->middleOutOrder()) == view(c.middleOutOrder()));
+
+        // Sorted views point into the mapping rather than a copy of it
+        const int* first = &*mapped->order().begin();
+        const int* smallest = &*mapped->ascendingOrder().begin();
+        CHECK(smallest >= first);
+        CHECK(smallest < first + 5);
+
+        // Views keep the mapping alive
+        auto order = mapped->order();
+        auto cross = mapped->sideCrossOrder();
+        mapped.reset();
+        CHECK(view(order) == std::vector<int>{7, 15, 6, 1, 2});
+        CHECK(view(cross) == std::vector<int>{1, 15, 2, 7, 6});
+    }
+
+    MyContainer<Point> points;
+    points.add(Point{3, 1, "c"});
+    points.add(Point{1, 2, "a"});
+    points.save(file.path);
+    MappedContainer<Point> mappedPoints(file.path);
+    CHECK(std::string(mappedPoints.ascendingOrder().begin()->label) == "a");
+}
+
+TEST_CASE("Binary files are validated") {
+    TempFile file("invalid");
+    MyContainer<int> c{1, 2, 3};
+    c.save(file.path, true);
+
+    MyContainer<float> floats;
+    CHECK_THROWS_AS(floats.load(file.path), std::runtime_error);          // int file as float
+    CHECK_THROWS_AS(MappedContainer<unsigned>(file.path), std::runtime_error);
+    CHECK_THROWS_AS(MappedContainer<int>(file.path + "-missing"), std::system_error);
+
+    auto rewrite = [&file](size_t offset, const std::string& bytes, size_t truncate = 0) {
+        std::fstream io(file.path, std::ios::in | std::ios::out | std::ios::binary);
+        io.seekp(static_cast<std::streamoff>(offset));
+        io.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        io.close();
+        if (truncate) REQUIRE(::truncate(file.path.c_str(), static_cast<off_t>(truncate)) == 0);
+    };
+
+    rewrite(0, "NOTMINE!");
+    CHECK_THROWS_AS(MappedContainer<int>(file.path), std::runtime_error);
+
+    c.save(file.path);
+    rewrite(8, std::string("\x02\0\0\0", 4));  // version 2
+    CHECK_THROWS_AS(MappedContainer<int>(file.path), std::runtime_error);
+
+    c.save(file.path);
+    rewrite(0, "", 64 + 2 * sizeof(int));  // one element cut off
+    CHECK_THROWS_AS(MappedContainer<int>(file.path), std::runtime_error);
+
+    c.save(file.path, true);
+    rewrite(64 + 3 * sizeof(int) + 4, std::string("\x09\0\0\0", 4));  // permutation entry 9 of 3
+    MyContainer<int> corrupt;
+    CHECK_THROWS_AS(corrupt.load(file.path), std::out_of_range);
+}
+
+TEST_CASE("Sorted views spill to disk above the memory limit") {
+    char dirTemplate[] = "/tmp/mycontainer-spill-test-XXXXXX";
+    REQUIRE(mkdtemp(dirTemplate) != nullptr);
+    std::string dir = dirTemplate;
+
+    std::vector<int> values(20000);
+    unsigned seed = 7;
+    for (auto& v : values) {
+        seed = seed * 1103515245u + 12345u;
+        v = static_cast<int>(seed % 5000) - 2500;  // Many duplicates
+    }
+    MyContainer<int> inRam(values.begin(), values.end());
+    MyContainer<int> spilled(values.begin(), values.end());
+    spilled.setSortMemoryLimit(4096, dir);  // 512-element runs, 40 of them, merged 2 at a time
+
+    auto all = [](const auto& view) {
+        using T = std::decay_t<decltype(*view.begin())>;
+        return std::vector<T>(view.begin(), view.end());
+    };
+    stats::reset();
+    CHECK(all(spilled.ascendingOrder()) == all(inRam.ascendingOrder()));
+    CHECK(all(spilled.descendingOrder()) == all(inRam.descendingOrder()));
+    CHECK(all(spilled.sideCrossOrder()) == all(inRam.sideCrossOrder()));
+    CHECK(stats::snapshot()[stats::Sort].calls == 2);
+
+    // 10 runs merged 3 at a time: passes of 4 and 2 runs, one group holding a single run
+    MyContainer<int> widerMerge(values.begin(), values.end());
+    widerMerge.setSortMemoryLimit(16384, dir);
+    CHECK(all(widerMerge.ascendingOrder()) == all(inRam.ascendingOrder()));
+
+    // Random access still works, and a view outlives the index being rebuilt
+    auto asc = spilled.ascendingOrder();
+    CHECK(asc.begin()[10000] == all(inRam.ascendingOrder())[10000]);
+    spilled.add(9999);
+    CHECK(*(asc.end() - 1) != 9999);
+    CHECK(*(spilled.ascendingOrder().end() - 1) == 9999);
+
+    // Permutation mode spills whole values, so the view no longer borrows the storage
+    MyContainer<Point> points;
+    points.setPermutationSort(true);
+    for (int i = 0; i < 300; ++i) points.add(Point{(i * 37) % 300, i, "p"});
+    points.setSortMemoryLimit(1024, dir);  // 300 positions need 2400 bytes
+    auto sortedPoints = points.ascendingOrder();
+    CHECK(std::is_sorted(sortedPoints.begin(), sortedPoints.end()));
+    points.add(Point{-1, 0, "n"});
+    CHECK(sortedPoints.begin()->x == 0);
+
+    // Non-contiguous storage spills as well; a small container stays in RAM
+    MyContainer<double, ChunkedStorage<double>> chunked{3.5, -1.0, 2.0, 8.0, 0.5};
+    chunked.setSortMemoryLimit(32, dir);
+    CHECK(all(chunked.ascendingOrder()) == std::vector<double>{-1.0, 0.5, 2.0, 3.5, 8.0});
+    chunked.setSortMemoryLimit(1 << 20, dir);
+    chunked.add(1.0);
+    CHECK(all(chunked.descendingOrder()) == std::vector<double>{8.0, 3.5, 2.0, 1.0, 0.5, -1.0});
+
+    // Spill files are unlinked at once – nothing is left behind
+    CHECK(rmdir(dir.c_str()) == 0);
+    spilled.add(1);
+    spilled.setSortMemoryLimit(4096, dir);
+    CHECK_THROWS_AS(spilled.ascendingOrder(), std::system_error);
+}
+
+TEST_CASE("Segmented storage matches vector storage") {
+    checkMatchesVectorStorage<SegmentedStorage<int>>();
+
+    // Removing everything keeps the chunks for reuse; adds after that still line up
+    constexpr int n = 10000;
+    MyContainer<int, SegmentedStorage<int>> segmented;
+    for (int i = 0; i < n; ++i) {
+        segmented.add(i);
+    }
+    segmented.removeIf([](int) { return true; });
+    CHECK(segmented.size() == 0);
+    std::vector<int> items(n);
+    std::iota(items.rbegin(), items.rend(), 0);
+    segmented.addRange(items.begin(), items.end());
+    CHECK(sameElements(segmented.order(), items));
+}
+
+TEST_CASE("Segmented storage copies, moves and destroys its elements") {
+    MyContainer<std::string, SegmentedStorage<std::string>> words;
+    words.reserve(5000);
+    for (int i = 0; i < 5000; ++i) {
+        words.add("word-" + std::to_string(i) + "-long-enough-to-allocate");
+    }
+    MyContainer<std::string, SegmentedStorage<std::string>> copy = words;
+    words.removeIf([](const std::string& w) { return w.back() != 'e'; });
+    CHECK(words.size() == 5000);
+    copy.removeIf([](const std::string& w) { return w[5] != '1'; });
+    CHECK(copy.size() == 1111);
+    CHECK(*copy.order().begin() == "word-1-long-enough-to-allocate");
+
+    MyContainer<std::string, SegmentedStorage<std::string>> moved = std::move(copy);
+    CHECK(moved.size() == 1111);
+    CHECK(*(moved.ascendingOrder().end() - 1) == "word-1999-long-enough-to-allocate");
+    words = moved;
+    CHECK(words.size() == 1111);
+}
+
+// Counts live instances; the copy numbered failAt throws
+struct Tracked {
+    static inline int live = 0;
+    static inline int copies = 0;
+    static inline int failAt = -1;
+
+    Tracked() { ++live; }
+    Tracked(const Tracked&) {
+        if (copies++ == failAt) {
+            throw std::runtime_error("copy failed");
+        }
+        ++live;
+    }
+    ~Tracked() { --live; }
+};
+
+TEST_CASE("Segmented storage range constructor cleans up when a copy throws") {
+    {
+        std::vector<Tracked> source(10000);
+        Tracked::copies = 0;
+        Tracked::failAt = 9000;  // after a few chunks are filled
+        CHECK_THROWS_AS(SegmentedStorage<Tracked>(source.begin(), source.end()), std::runtime_error);
+        CHECK(Tracked::live == 10000);
+        Tracked::failAt = -1;
+    }
+    CHECK(Tracked::live == 0);
+}
+
+TEST_CASE("Exact membership index answers contains and count in O(1)") {
+    MyContainer<int> c{4, 1, 4, 7};
+    CHECK(c.contains(7));
+    CHECK(c.count(4) == 2);
+    CHECK_FALSE(c.contains(5));  // no index yet – a scan
+
+    c.setMembershipIndex(Membership::Exact);
+    CHECK(c.count(4) == 2);
+    c.add(5);
+    c.emplace(5);
+    std::vector<int> more{9, 9, 9};
+    c.addRange(more.begin(), more.end());
+    CHECK(c.count(5) == 2);
+    CHECK(c.count(9) == 3);
+
+    // A missing value is rejected without scanning the container
+    stats::reset();
+    CHECK_THROWS_AS(c.remove(42), std::invalid_argument);
+    CHECK(c.removeAll(42, 43) == 0);
+    CHECK(stats::snapshot()[stats::Remove].elements == 0);
+
+    c.remove(4);
+    CHECK(c.removeIf([](int v) { return v == 1 || v == 5; }) == 3);
+    CHECK(c.removeAll(9, 42) == 3);
+    CHECK_FALSE(c.contains(4));
+    CHECK_FALSE(c.contains(9));
+    CHECK(c.count(7) == 1);
+    CHECK(c.size() == 1);
+
+    // Copies keep their own index
+    MyContainer<int> copy = c;
+    copy.add(4);
+    CHECK(copy.contains(4));
+    CHECK_FALSE(c.contains(4));
+
+    MyContainer<std::string, SegmentedStorage<std::string>> words{"fig", "pear", "fig"};
+    words.setMembershipIndex(Membership::Exact);
+    CHECK(words.count("fig") == 2);
+    words.remove("fig");
+    CHECK_FALSE(words.contains("fig"));
+    CHECK(words.contains("pear"));
+
+    // A predicate that throws partway leaves the index matching what the storage kept
+    MyContainer<int, OrderedStorage<int>> ordered{1, 2, 1, 3, 1, 2};
+    ordered.setMembershipIndex(Membership::Exact);
+    int seen = 0;
+    CHECK_THROWS_AS(ordered.removeIf([&seen](int v) {
+        if (v == 1 && ++seen == 3) {
+            throw std::runtime_error("stop");
+        }
+        return v == 1 || v == 2;
+    }), std::runtime_error);
+    MyContainer<int, OrderedStorage<int>> scanned = ordered;
+    scanned.setMembershipIndex(Membership::None);
+    for (int v : {1, 2, 3}) {
+        CHECK(ordered.count(v) == scanned.count(v));
+    }
+    CHECK(ordered.size() == 3);
+    CHECK(ordered.count(1) == 1);
+}
+
+TEST_CASE("Membership filter never misses a present value") {
+    MyContainer<int> c;
+    c.setMembershipIndex(Membership::Filter, 100);
+    for (int i = 0; i < 5000; ++i) {
+        c.add(i * 2);  // grows well past the sized 100 – the filter is rebuilt
+    }
+    for (int i = 0; i < 5000; ++i) {
+        CHECK(c.contains(i * 2));
+    }
+    stats::reset();
+    for (int i = 0; i < 5000; ++i) {
+        CHECK_THROWS_AS(c.remove(i * 2 + 1), std::invalid_argument);
+    }
+    size_t falseScans = stats::snapshot()[stats::Remove].elements / c.size();
+    CHECK(falseScans < 250);  // most missing values are rejected without a scan
+
+    CHECK(c.removeIf([](int v) { return v % 4 == 0; }) == 2500);
+    c.removeAll(2, 6, 10);
+    c.remove(14);
+    CHECK_FALSE(c.contains(0));
+    CHECK(c.count(18) == 1);
+    CHECK(c.size() == 2496);
+
+    // removeAll takes each value's own occurrences out of the filter, so they are ruled
+    // out again without a scan
+    MyContainer<int> dups{3, 3, 5, 8, 8, 8};
+    dups.setMembershipIndex(Membership::Filter);
+    CHECK(dups.removeAll(3, 8) == 5);
+    stats::reset();
+    CHECK_THROWS_AS(dups.remove(3), std::invalid_argument);
+    CHECK_THROWS_AS(dups.remove(8), std::invalid_argument);
+    CHECK(stats::snapshot()[stats::Remove].elements == 0);
+    CHECK(dups.contains(5));
+
+    // Types without std::hash cannot have an index
+    MyContainer<Point> points;
+    CHECK_THROWS_AS(points.setMembershipIndex(Membership::Exact), std::logic_error);
+    CHECK_NOTHROW(points.setMembershipIndex(Membership::None));
+}
+
+TEST_CASE("Tombstone storage matches vector storage across compactions") {
+    checkMatchesVectorStorage<TombstoneStorage<int>>();
+
+    constexpr int n = 5000;
+    MyContainer<int, TombstoneStorage<int>> tombstones;
+    MyContainer<int> plain;
+    for (int i = 0; i < n; ++i) {
+        tombstones.add(i % 1000);  // five copies of each value
+        plain.add(i % 1000);
+    }
+
+    // Remove values one at a time: slots are buried, then compacted in batches
+    for (int v = 0; v < 800; v += 2) {
+        tombstones.remove(v);
+        plain.remove(v);
+        CHECK(tombstones.size() == plain.size());
+        if (v % 100 == 0) {
+            CHECK(sameElements(tombstones.order(), plain.order()));
+        }
+    }
+    CHECK_THROWS_AS(tombstones.remove(0), std::invalid_argument);
+    tombstones.add(5);
+    plain.add(5);
+    CHECK(sameElements(tombstones.order(), plain.order()));
+    CHECK(tombstones.count(5) == 6);
+
+    // A copy keeps the dead slots and index consistent on its own
+    auto items = plain.order();
+    MyContainer<int, TombstoneStorage<int, 90>> lazy(items.begin(), items.end());
+    lazy.remove(7);
+    MyContainer<int, TombstoneStorage<int, 90>> copy = lazy;
+    copy.remove(5);
+    CHECK(copy.size() == lazy.size() - 6);
+    CHECK_FALSE(copy.contains(5));
+    CHECK(lazy.contains(5));
+    CHECK_FALSE(copy.contains(7));
+}
+
+// Key that counts its equality comparisons, to check removals don't rescan runs of duplicates
+struct CountedKey {
+    int value;
+    static inline size_t comparisons = 0;
+
+    bool operator==(const CountedKey& other) const {
+        ++comparisons;
+        return value == other.value;
+    }
+
+    bool operator<(const CountedKey& other) const {
+        return value < other.value;
+    }
+};
+
+namespace std {
+    template<>
+    struct hash<CountedKey> {
+        size_t operator()(const CountedKey& key) const {
+            return std::hash<int>()(key.value);
+        }
+    };
+}
+
+TEST_CASE("Tombstone removeIf stays linear with many duplicates") {
+    constexpr int n = 20000;
+    MyContainer<CountedKey, TombstoneStorage<CountedKey, 90>> c;
+    for (int i = 0; i < n; ++i) {
+        c.add(CountedKey{i % 4});
+    }
+    CountedKey::comparisons = 0;
+    CHECK(c.removeIf([](const CountedKey& k) { return k.value == 1; }) == n / 4);
+    CHECK(c.removeIf([](const CountedKey& k) { return k.value == 2; }) == n / 4);
+    CHECK(CountedKey::comparisons < 10 * n);  // rescanning each run cost ~n * n / 16
+    c.remove(CountedKey{3});  // the index still finds the survivors
+    CHECK(c.size() == n / 4);
+    CHECK(c.ascendingOrder().begin()[n / 4 - 1].value == 0);
+}
+
+TEST_CASE("Range adaptors compose lazily over the order views") {
+    using namespace adaptors;
+    MyContainer<int> c{9, 4, 7, 2, 8, 1, 6, 3, 10, 5};
+    auto even = [](int v) { return v % 2 == 0; };
+    auto twice = [](int v) { return v * 2; };
+    auto collect = [](const auto& range) {
+        using T = std::decay_t<decltype(*range.begin())>;
+        return std::vector<T>(range.begin(), range.end());
+    };
+
+    // The first three even values in ascending order, doubled – a temporary view is moved in
+    auto firstEvens = c.ascendingOrder() | filter(even) | take(3) | transform(twice);
+    CHECK(collect(firstEvens) == std::vector<int>{4, 8, 12});
+
+    // An lvalue view is referenced, and every order view can be adapted
+    auto desc = c.descendingOrder();
+    CHECK(collect(desc | stride(3)) == std::vector<int>{10, 7, 4, 1});
+    CHECK(collect(c.order() | take(4) | filter(even)) == std::vector<int>{4, 2});
+    CHECK(collect(c.reverseOrder() | transform(twice) | take(2)) == std::vector<int>{10, 20});
+    CHECK(collect(c.sideCrossOrder() | take(4)) == std::vector<int>{1, 10, 2, 9});
+    CHECK(collect(c.middleOutOrder() | filter(even) | stride(2)).size() == 3);
+
+    // Edge cases: take beyond the end, take(0), a filter rejecting everything, step past the end
+    CHECK(collect(c.ascendingOrder() | take(100)).size() == 10);
+    CHECK(collect(c.ascendingOrder() | take(0)).empty());
+    CHECK(collect(c.ascendingOrder() | filter([](int v) { return v > 100; })).empty());
+    CHECK(collect(c.ascendingOrder() | stride(20)) == std::vector<int>{1});
+    CHECK_THROWS_AS(stride(0), std::invalid_argument);
+    CHECK(collect(c.order() | filter([](int v) { return v < 0; }) | take(1) | stride(2)).empty());
+
+    // Nothing is evaluated until iteration, and only as far as it goes
+    int calls = 0;
+    auto counted = c.ascendingOrder() | transform([&calls](int v) { ++calls; return v; }) | take(2);
+    CHECK(calls == 0);
+    for (int v : counted) {
+        CHECK(v > 0);
+    }
+    CHECK(calls == 2);
+
+    // Works with standard algorithms and other ranges
+    std::vector<std::string> words{"kiwi", "fig", "banana", "pear"};
+    auto lengths = words | filter([](const std::string& w) { return w.size() > 3; })
+                         | transform([](const std::string& w) { return w.size(); });
+    CHECK(std::accumulate(lengths.begin(), lengths.end(), size_t(0)) == 14);
+    auto asc = c.ascendingOrder<UncheckedIterators>() | stride(2);
+    CHECK(std::distance(asc.begin(), asc.end()) == 5);
+    CHECK(*std::max_element(asc.begin(), asc.end()) == 9);
+}
+
+TEST_CASE("Assigning a container invalidates the views of both sides") {
+    MyContainer<int> a{1};
+    MyContainer<int> c{2};  // same number of changes as a
+    auto borrowed = a.orderView();
+    a.setPermutationSort(true);
+    auto sorted = a.ascendingOrder();
+    a = c;
+    CHECK_THROWS_AS(*borrowed.begin(), std::logic_error);
+    CHECK_THROWS_AS(*sorted.begin(), std::logic_error);
+    CHECK(*a.orderView().begin() == 2);
+
+    auto fromC = c.orderView();
+    auto cSorted = c.ascendingOrder();
+    MyContainer<int> b{3};
+    b = std::move(c);
+    CHECK_THROWS_AS(*fromC.begin(), std::logic_error);
+    CHECK(*cSorted.begin() == 2);  // a value index owns its data
+    CHECK(*b.ascendingOrder().begin() == 2);
+
+    MyContainer<int> moved(std::move(b));
+    CHECK(*moved.orderView().begin() == 2);
+}